@@ -9,6 +9,15 @@ public class FGNetTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+
+		// Push model needs a unique build environment, which an installed engine cannot build. Without it the
+		// properties are still sent, they are just compared every update instead of only when marked dirty.
+		if (!UnrealBuildTool.IsEngineInstalled())
+		{
+			BuildEnvironment = TargetBuildEnvironment.Unique;
+			bWithPushModel = true;
+		}
+
 		ExtraModuleNames.AddRange( new string[] { "FGNet" } );
 	}
 }
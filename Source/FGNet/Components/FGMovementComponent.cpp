@@ -40,9 +40,30 @@ void UFGMovementComponent::Move(FFGFrameMovement& FrameMovement)
 	FrameMovement.FinalLocation = UpdatedComponent->GetComponentLocation();
 }
 
-void UFGMovementComponent::ApplyGravity()
+void UFGMovementComponent::ApplyGravity(float DeltaTime)
 {
-	AccumulatedGravity += Gravity * GetWorld()->GetDeltaSeconds();
+	AccumulatedGravity += Gravity * DeltaTime;
+}
+
+int32 UFGMovementComponent::ConsumeFixedSteps(float DeltaTime)
+{
+	FixedStepAccumulator += DeltaTime;
+
+	const int32 NumSteps = FMath::FloorToInt(FixedStepAccumulator / FixedTimeStep);
+	FixedStepAccumulator -= NumSteps * FixedTimeStep;
+
+	if (NumSteps > MaxSubSteps)
+	{
+		FixedStepAccumulator = 0.0f;
+		return MaxSubSteps;
+	}
+
+	return NumSteps;
+}
+
+int32 UFGMovementComponent::GetNumFixedSteps(float DeltaTime) const
+{
+	return FMath::Max(FMath::RoundToInt(DeltaTime / FixedTimeStep), 1);
 }
 
 void UFGMovementComponent::SetFacingRotation(const FQuat& InFacingRotation, float InRotationSpeed)
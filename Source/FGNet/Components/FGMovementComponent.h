@@ -17,12 +17,34 @@ public:
 
 	void Move(FFGFrameMovement& FrameMovement);
 
-	void ApplyGravity();
+	void ApplyGravity(float DeltaTime);
 
 	UPROPERTY(EditAnywhere, Category = "Movement")
 	float Gravity = 30.0f;
 
+	//Simulate in fixed steps, the same input sequence then gives the same result at any framerate.
+	UPROPERTY(EditAnywhere, Category = "Movement")
+	bool bUseFixedTimeStep = true;
+
+	UPROPERTY(EditAnywhere, Category = "Movement", meta = (ClampMin = 0.001, EditCondition = "bUseFixedTimeStep"))
+	float FixedTimeStep = 1.0f / 60.0f;
+
+	//Most steps we run in one frame, time beyond that is dropped so a hitch can't make the next frame even slower.
+	UPROPERTY(EditAnywhere, Category = "Movement", meta = (ClampMin = 1, EditCondition = "bUseFixedTimeStep"))
+	int32 MaxSubSteps = 4;
+
+	//Adds frame time to the accumulator and returns how many fixed steps to run now.
+	int32 ConsumeFixedSteps(float DeltaTime);
+
+	//How many fixed steps a move of DeltaTime covers, at least one.
+	int32 GetNumFixedSteps(float DeltaTime) const;
+
+	//How far we are into the next fixed step, 1 when not using fixed steps.
+	float GetFixedStepAlpha() const { return bUseFixedTimeStep ? FixedStepAccumulator / FixedTimeStep : 1.0f; }
+
 	FVector GetGravityAsVector() const { return FVector(0.0f, 0.0f, AccumulatedGravity); }
+	float GetAccumulatedGravity() const { return AccumulatedGravity; }
+	void SetAccumulatedGravity(float InAccumulatedGravity) { AccumulatedGravity = InAccumulatedGravity; }
 	FRotator GetFacingRotation() const { return FacingRotationCurrent; }
 	FVector GetFacingDirection() const { return FacingRotationCurrent.Vector(); }
 
@@ -39,6 +61,7 @@ private:
 
 	FRotator FacingRotationCurrent;
 	FRotator FacingRotationTarget;
-	float AccumulatedGravity;
+	float AccumulatedGravity = 0.0f;
+	float FixedStepAccumulator = 0.0f;
 	float FacingRotationSpeed = 1.0f;
 };
\ No newline at end of file
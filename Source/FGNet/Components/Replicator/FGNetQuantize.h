@@ -0,0 +1,279 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "FGNetQuantize.generated.h"
+
+//Wire precision for the typed smooth replicators, override these from Build.cs (PublicDefinitions) to trade precision for bandwidth.
+
+//Fixed point scale for vectors, 10 = one millimeter.
+#ifndef FGNET_VECTOR_QUANTIZE_SCALE
+#define FGNET_VECTOR_QUANTIZE_SCALE 10
+#endif
+
+//Upper bound of bits per vector component, vectors with a component that does not fit are sent as full floats.
+#ifndef FGNET_VECTOR_QUANTIZE_MAX_BITS
+#define FGNET_VECTOR_QUANTIZE_MAX_BITS 24
+#endif
+
+//Bits per rotator axis, 16 matches FRotator::SerializeCompressedShort.
+#ifndef FGNET_ROTATOR_QUANTIZE_BITS
+#define FGNET_ROTATOR_QUANTIZE_BITS 12
+#endif
+
+//Bits for each of the three smallest quaternion components.
+#ifndef FGNET_QUAT_QUANTIZE_BITS
+#define FGNET_QUAT_QUANTIZE_BITS 11
+#endif
+
+struct FFGNetQuantize
+{
+	//SerializePackedVector clamps components that do not fit in MaxBitsPerComponent. One extra bit says whether the
+	//vector fits, the rare ones that do not are sent as full floats instead.
+	template<uint32 ScaleFactor, int32 MaxBitsPerComponent>
+	static bool SerializeVector(FVector& Vector, FArchive& Ar)
+	{
+		static_assert(MaxBitsPerComponent > 1 && MaxBitsPerComponent <= 30, "Packed components must fit in an int32.");
+		uint8 bFits = 1;
+
+		if (Ar.IsSaving())
+		{
+			const FVector Scaled = Vector * ScaleFactor;
+			bFits = !Scaled.ContainsNaN() && Scaled.GetAbsMax() < static_cast<float>((1 << MaxBitsPerComponent) - 1);
+		}
+
+		Ar.SerializeBits(&bFits, 1);
+
+		if (bFits)
+		{
+			return SerializePackedVector<ScaleFactor, MaxBitsPerComponent>(Vector, Ar);
+		}
+
+		Ar << Vector;
+		return !Ar.IsError();
+	}
+
+	//Rounds to the fixed point grid SerializeVector sends with the same scale.
+	template<uint32 ScaleFactor>
+	static FVector QuantizeVector(const FVector& Value)
+	{
+		return FVector(
+			FMath::RoundToFloat(Value.X * ScaleFactor),
+			FMath::RoundToFloat(Value.Y * ScaleFactor),
+			FMath::RoundToFloat(Value.Z * ScaleFactor)) / ScaleFactor;
+	}
+
+	//Angle in degrees, wraps around.
+	template<int32 NumBits>
+	static uint32 QuantizeAxis(float Value)
+	{
+		static_assert(NumBits > 1 && NumBits <= 16, "Axes are limited to 16 bits.");
+		const uint32 Resolution = 1u << NumBits;
+		return static_cast<uint32>(FMath::RoundToInt(FRotator::ClampAxis(Value) * (Resolution / 360.0f))) & (Resolution - 1);
+	}
+
+	//Returns [0, 360).
+	template<int32 NumBits>
+	static float DequantizeAxis(uint32 Value)
+	{
+		return static_cast<float>(Value) * (360.0f / (1u << NumBits));
+	}
+
+	//Seconds to whole milliseconds, times before zero become zero.
+	static uint32 QuantizeTime(float Value)
+	{
+		return static_cast<uint32>(FMath::Max(FMath::RoundToInt(Value * 1000.0f), 0));
+	}
+
+	static float DequantizeTime(uint32 Value)
+	{
+		return static_cast<float>(Value) / 1000.0f;
+	}
+
+	template<int32 NumBits>
+	static uint32 QuantizeSigned(float Value, float Range)
+	{
+		static_assert(NumBits > 1 && NumBits <= 30, "Quantized components must fit in an uint32.");
+		const uint32 MaxValue = (1u << NumBits) - 1;
+		const float Normalized = (FMath::Clamp(Value, -Range, Range) + Range) / (2.0f * Range);
+		return FMath::Min(static_cast<uint32>(FMath::RoundToInt(Normalized * MaxValue)), MaxValue);
+	}
+
+	template<int32 NumBits>
+	static float DequantizeSigned(uint32 Value, float Range)
+	{
+		const uint32 MaxValue = (1u << NumBits) - 1;
+		return (static_cast<float>(Value) / static_cast<float>(MaxValue)) * 2.0f * Range - Range;
+	}
+
+	template<int32 NumBits>
+	static void SerializeRotator(FRotator& Rotator, FArchive& Ar)
+	{
+		float* Axes[3] = { &Rotator.Pitch, &Rotator.Yaw, &Rotator.Roll };
+
+		for (float* Axis : Axes)
+		{
+			uint32 Quantized = 0;
+
+			if (Ar.IsSaving())
+			{
+				Quantized = QuantizeAxis<NumBits>(*Axis);
+			}
+
+			//Most actors only yaw, so zero axes only cost one bit.
+			uint8 bNonZero = Quantized != 0;
+			Ar.SerializeBits(&bNonZero, 1);
+
+			if (bNonZero)
+			{
+				Ar.SerializeBits(&Quantized, NumBits);
+			}
+
+			if (Ar.IsLoading())
+			{
+				*Axis = bNonZero ? FRotator::NormalizeAxis(DequantizeAxis<NumBits>(Quantized)) : 0.0f;
+			}
+		}
+	}
+
+	//Smallest three: send which component was largest and drop it, it can be rebuilt from the unit length.
+	template<int32 NumBits>
+	static void SerializeQuat(FQuat& Quat, FArchive& Ar)
+	{
+		const float Range = 0.70710678f;
+
+		uint32 LargestIndex = 0;
+		uint32 Quantized[3] = { 0, 0, 0 };
+
+		if (Ar.IsSaving())
+		{
+			FQuat Normalized = Quat.GetNormalized();
+			const float Components[4] = { Normalized.X, Normalized.Y, Normalized.Z, Normalized.W };
+
+			for (uint32 Index = 1; Index < 4; Index++)
+			{
+				if (FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]))
+				{
+					LargestIndex = Index;
+				}
+			}
+
+			//q and -q are the same rotation, flip so the dropped component is always positive.
+			const float Sign = Components[LargestIndex] < 0.0f ? -1.0f : 1.0f;
+
+			for (uint32 Index = 0, Out = 0; Index < 4; Index++)
+			{
+				if (Index != LargestIndex)
+				{
+					Quantized[Out++] = QuantizeSigned<NumBits>(Components[Index] * Sign, Range);
+				}
+			}
+		}
+
+		Ar.SerializeBits(&LargestIndex, 2);
+
+		for (uint32& Component : Quantized)
+		{
+			Ar.SerializeBits(&Component, NumBits);
+		}
+
+		if (Ar.IsLoading())
+		{
+			float Components[4];
+			float SumSquared = 0.0f;
+
+			for (uint32 Index = 0, In = 0; Index < 4; Index++)
+			{
+				if (Index != LargestIndex)
+				{
+					Components[Index] = DequantizeSigned<NumBits>(Quantized[In++], Range);
+					SumSquared += FMath::Square(Components[Index]);
+				}
+			}
+
+			Components[LargestIndex] = FMath::Sqrt(FMath::Max(0.0f, 1.0f - SumSquared));
+			Quat = FQuat(Components[0], Components[1], Components[2], Components[3]);
+			Quat.Normalize();
+		}
+	}
+};
+
+USTRUCT()
+struct FFGNetQuantizedVector
+{
+	GENERATED_BODY()
+
+	FFGNetQuantizedVector() {}
+	FFGNetQuantizedVector(const FVector& InValue) : Value(InValue) {}
+
+	FVector Value = FVector::ZeroVector;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = FFGNetQuantize::SerializeVector<FGNET_VECTOR_QUANTIZE_SCALE, FGNET_VECTOR_QUANTIZE_MAX_BITS>(Value, Ar);
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedVector> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedVector>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+USTRUCT()
+struct FFGNetQuantizedRotator
+{
+	GENERATED_BODY()
+
+	FFGNetQuantizedRotator() {}
+	FFGNetQuantizedRotator(const FRotator& InValue) : Value(InValue) {}
+
+	FRotator Value = FRotator::ZeroRotator;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		FFGNetQuantize::SerializeRotator<FGNET_ROTATOR_QUANTIZE_BITS>(Value, Ar);
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedRotator> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedRotator>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+USTRUCT()
+struct FFGNetQuantizedQuat
+{
+	GENERATED_BODY()
+
+	FFGNetQuantizedQuat() {}
+	FFGNetQuantizedQuat(const FQuat& InValue) : Value(InValue) {}
+
+	FQuat Value = FQuat::Identity;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		FFGNetQuantize::SerializeQuat<FGNET_QUAT_QUANTIZE_BITS>(Value, Ar);
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGNetQuantizedQuat> : public TStructOpsTypeTraitsBase2<FFGNetQuantizedQuat>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
@@ -0,0 +1,53 @@
+#include "FGQuatReplicator.h"
+#include "Net/UnrealNetwork.h"
+
+void UFGQuatReplicator::Tick(float DeltaTime)
+{
+	if (Smoothing.Tick(*this, DeltaTime))
+	{
+		BroadcastDelegate();
+	}
+}
+
+void UFGQuatReplicator::Init()
+{
+	Smoothing.Init(*this);
+}
+
+void UFGQuatReplicator::SetValue(const FQuat& InValue)
+{
+	if (Smoothing.SetValue(*this, InValue))
+	{
+		BroadcastDelegate();
+	}
+}
+
+FQuat UFGQuatReplicator::GetValue() const
+{
+	return Smoothing.GetValue();
+}
+
+void UFGQuatReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedQuat TerminalValue)
+{
+	Multicast_SendTerminalValue(SyncTag, TerminalValue);
+}
+
+void UFGQuatReplicator::Server_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue)
+{
+	Multicast_SendReplicatedValue(SyncTag, ReplicatedValue);
+}
+
+void UFGQuatReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue)
+{
+	Smoothing.ReceiveTerminalValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+void UFGQuatReplicator::Multicast_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue)
+{
+	Smoothing.ReceiveValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+bool UFGQuatReplicator::ShouldTick() const
+{
+	return Smoothing.ShouldTick();
+}
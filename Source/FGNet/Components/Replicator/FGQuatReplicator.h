@@ -0,0 +1,41 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+#include "FGSmoothReplicator.h"
+#include "FGNetQuantize.h"
+#include "FGQuatReplicator.generated.h"
+
+UCLASS()
+class FGNET_API UFGQuatReplicator : public UFGReplicatorBase
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void Init() override;
+
+	UFUNCTION(Server, Reliable)
+	void Server_SendTerminalValue(int32 SyncTag, FFGNetQuantizedQuat TerminalValue);
+
+	UFUNCTION(Server, Unreliable)
+	void Server_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_SendTerminalValue(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedQuat ReplicatedValue);
+
+	//FQuat is not exposed to Blueprint, use the rotator replicator there.
+	void SetValue(const FQuat& InValue);
+
+	FQuat GetValue() const;
+
+	bool ShouldTick() const;
+
+private:
+
+	TFGSmoothReplicator<FQuat, FFGNetQuantizedQuat> Smoothing = TFGSmoothReplicator<FQuat, FFGNetQuantizedQuat>(FQuat::Identity);
+};
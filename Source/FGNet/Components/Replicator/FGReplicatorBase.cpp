@@ -3,6 +3,7 @@
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "Net/UnrealNetwork.h"
+#include "../../Debug/FGNetTrafficSubsystem.h"
 
 int32 UFGReplicatorBase::GetFunctionCallspace(UFunction* Function, FFrame* Stack)
 {
@@ -17,6 +18,10 @@ bool UFGReplicatorBase::CallRemoteFunction(UFunction* Function, void* Parameters
 
 	AActor* OwnerActor = CastChecked<AActor>(GetOuter());
 
+#if FGNET_TRAFFIC_STATS
+	UFGNetTrafficSubsystem::RecordSentRpc(this, Function, Parameters);
+#endif
+
 	bool bProcessed = false;
 
 	FWorldContext* const Context = GEngine->GetWorldContextFromWorld(GetWorld());
@@ -36,6 +41,15 @@ bool UFGReplicatorBase::CallRemoteFunction(UFunction* Function, void* Parameters
 	return bProcessed;
 }
 
+void UFGReplicatorBase::ProcessEvent(UFunction* Function, void* Parameters)
+{
+#if FGNET_TRAFFIC_STATS
+	UFGNetTrafficSubsystem::RecordProcessedRpc(this, Function, Parameters);
+#endif
+
+	Super::ProcessEvent(Function, Parameters);
+}
+
 bool UFGReplicatorBase::IsSupportedForNetworking() const
 {
 	return true;
@@ -52,6 +66,16 @@ void UFGReplicatorBase::Tick(float DeltaTime)
 }
 
 bool UFGReplicatorBase::IsTickable() const
+{
+	return bShouldTick && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+void UFGReplicatorBase::SetShouldTick(bool bInShouldTick)
+{
+	bShouldTick = bInShouldTick;
+}
+
+bool UFGReplicatorBase::IsTicking() const
 {
 	return bShouldTick;
 }
@@ -61,6 +85,14 @@ TStatId UFGReplicatorBase::GetStatId() const
 	return UObject::GetStatID();
 }
 
+void UFGReplicatorBase::BroadcastDelegate()
+{
+	if (OnValueChanged.IsBound())
+	{
+		OnValueChanged.Broadcast();
+	}
+}
+
 bool UFGReplicatorBase::IsLocallyControlled() const
 {
 	if (!ensure(GetOuter() != nullptr))
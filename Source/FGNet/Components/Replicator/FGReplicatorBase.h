@@ -4,12 +4,21 @@
 #include "Tickable.h"
 #include "FGReplicatorBase.generated.h"
 
-UENUM()
+UENUM(BlueprintType)
 enum class EFGSmoothReplicatorMode : uint8
 {
-	ConstantVelocity
+	//Move towards the next crumb at the speed needed to reach it in one send interval.
+	ConstantVelocity,
+	//Cubic curve through the crumbs, smooth at the crumbs themselves.
+	Hermite,
+	//Linear between crumbs, keeps going with the last velocity for MaxExtrapolationTime when the trail runs dry.
+	LinearExtrapolation,
+	//Chase the newest crumb with a critically damped spring, never overshoots.
+	CriticallyDampedSpring
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFGOnSmoothValueReplicationChanged);
+
 template<typename ValueType>
 struct TFGSmoothReplicatorOperation
 {
@@ -17,6 +26,151 @@ struct TFGSmoothReplicatorOperation
 	{
 		CurrentValue = CurrentValue + (FrameTarget - CurrentValue) * Alpha;
 	}
+
+	//Alpha is not clamped, above 1 extrapolates past End.
+	static ValueType LerpUnclamped(const ValueType& Start, const ValueType& End, float Alpha)
+	{
+		return Start + (End - Start) * Alpha;
+	}
+
+	//Catmull-Rom tangents from the neighbouring crumbs.
+	static ValueType InterpHermite(const ValueType& Previous, const ValueType& Start, const ValueType& End, const ValueType& Next, float Alpha)
+	{
+		return FMath::CubicInterp(Start, (End - Previous) * 0.5f, End, (Next - Start) * 0.5f, Alpha);
+	}
+
+	static bool IsNearlyEqual(const ValueType& A, const ValueType& B)
+	{
+		return A.Equals(B);
+	}
+};
+
+template<>
+inline bool TFGSmoothReplicatorOperation<float>::IsNearlyEqual(const float& A, const float& B)
+{
+	return FMath::IsNearlyEqual(A, B);
+}
+
+//Rotators take the shortest way around instead of spinning through 360.
+template<>
+inline void TFGSmoothReplicatorOperation<FRotator>::InterpConstantVelocity(FRotator& CurrentValue, const FRotator& FrameTarget, float Alpha)
+{
+	CurrentValue = (CurrentValue + (FrameTarget - CurrentValue).GetNormalized() * Alpha).GetNormalized();
+}
+
+template<>
+inline FRotator TFGSmoothReplicatorOperation<FRotator>::LerpUnclamped(const FRotator& Start, const FRotator& End, float Alpha)
+{
+	return (Start + (End - Start).GetNormalized() * Alpha).GetNormalized();
+}
+
+template<>
+inline FRotator TFGSmoothReplicatorOperation<FRotator>::InterpHermite(const FRotator& Previous, const FRotator& Start, const FRotator& End, const FRotator& Next, float Alpha)
+{
+	//Unwrap around Start so the curve does not go the long way past +-180.
+	const FRotator UnwrappedEnd = Start + (End - Start).GetNormalized();
+	const FRotator UnwrappedPrevious = Start - (Start - Previous).GetNormalized();
+	const FRotator UnwrappedNext = UnwrappedEnd + (Next - End).GetNormalized();
+	return FMath::CubicInterp(Start, (UnwrappedEnd - UnwrappedPrevious) * 0.5f, UnwrappedEnd, (UnwrappedNext - Start) * 0.5f, Alpha).GetNormalized();
+}
+
+template<>
+inline void TFGSmoothReplicatorOperation<FQuat>::InterpConstantVelocity(FQuat& CurrentValue, const FQuat& FrameTarget, float Alpha)
+{
+	CurrentValue = FQuat::Slerp(CurrentValue, FrameTarget, Alpha);
+}
+
+template<>
+inline FQuat TFGSmoothReplicatorOperation<FQuat>::LerpUnclamped(const FQuat& Start, const FQuat& End, float Alpha)
+{
+	FVector Axis;
+	float Angle;
+	(End * Start.Inverse()).GetNormalized().ToAxisAndAngle(Axis, Angle);
+
+	//ToAxisAndAngle gives [0, 2PI], go the short way.
+	if (Angle > PI)
+	{
+		Angle -= 2.0f * PI;
+	}
+
+	return (FQuat(Axis, Angle * Alpha) * Start).GetNormalized();
+}
+
+template<>
+inline FQuat TFGSmoothReplicatorOperation<FQuat>::InterpHermite(const FQuat& Previous, const FQuat& Start, const FQuat& End, const FQuat& Next, float Alpha)
+{
+	FQuat StartTangent;
+	FQuat EndTangent;
+	FQuat::CalcTangents(Previous, Start, End, 0.0f, StartTangent);
+	FQuat::CalcTangents(Start, End, Next, 0.0f, EndTangent);
+	return FQuat::Squad(Start, StartTangent, End, EndTangent, Alpha);
+}
+
+//Critically damped spring (Game Programming Gems 4, 1.10), SmoothTime is roughly the time it takes to reach the target.
+template<typename ValueType>
+struct TFGSmoothReplicatorSpring
+{
+	ValueType Velocity = ValueType(0.0f);
+
+	void Reset()
+	{
+		Velocity = ValueType(0.0f);
+	}
+
+	void Step(ValueType& CurrentValue, const ValueType& Target, float SmoothTime, float DeltaTime)
+	{
+		const float Omega = 2.0f / FMath::Max(SmoothTime, KINDA_SMALL_NUMBER);
+		const float X = Omega * DeltaTime;
+		const float Exp = 1.0f / (1.0f + X + 0.48f * X * X + 0.235f * X * X * X);
+		const ValueType Change = CurrentValue - Target;
+		const ValueType Temp = (Velocity + Change * Omega) * DeltaTime;
+		Velocity = (Velocity - Temp * Omega) * Exp;
+		CurrentValue = Target + (Change + Temp) * Exp;
+	}
+};
+
+template<>
+inline void TFGSmoothReplicatorSpring<FRotator>::Step(FRotator& CurrentValue, const FRotator& Target, float SmoothTime, float DeltaTime)
+{
+	const float Omega = 2.0f / FMath::Max(SmoothTime, KINDA_SMALL_NUMBER);
+	const float X = Omega * DeltaTime;
+	const float Exp = 1.0f / (1.0f + X + 0.48f * X * X + 0.235f * X * X * X);
+	const FRotator Change = (CurrentValue - Target).GetNormalized();
+	const FRotator Temp = (Velocity + Change * Omega) * DeltaTime;
+	Velocity = (Velocity - Temp * Omega) * Exp;
+	CurrentValue = (Target + (Change + Temp) * Exp).GetNormalized();
+}
+
+//Quaternions spring the remaining angle to the target and slerp by how much of it was covered.
+template<>
+struct TFGSmoothReplicatorSpring<FQuat>
+{
+	float Velocity = 0.0f;
+
+	void Reset()
+	{
+		Velocity = 0.0f;
+	}
+
+	void Step(FQuat& CurrentValue, const FQuat& Target, float SmoothTime, float DeltaTime)
+	{
+		const float Angle = CurrentValue.AngularDistance(Target);
+
+		if (Angle <= KINDA_SMALL_NUMBER)
+		{
+			CurrentValue = Target;
+			Velocity = 0.0f;
+			return;
+		}
+
+		float NewAngle = Angle;
+		TFGSmoothReplicatorSpring<float> AngleSpring;
+		AngleSpring.Velocity = Velocity;
+		AngleSpring.Step(NewAngle, 0.0f, SmoothTime, DeltaTime);
+		Velocity = AngleSpring.Velocity;
+
+		CurrentValue = FQuat::Slerp(CurrentValue, Target, FMath::Clamp(1.0f - NewAngle / Angle, 0.0f, 1.0f));
+	}
 };
 
 UCLASS(Abstract, BlueprintType, Blueprintable)
@@ -30,6 +184,7 @@ public:
 	//UObject
 	virtual int32 GetFunctionCallspace(UFunction* Function, FFrame* Stack) override;
 	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) override;
 	virtual bool IsSupportedForNetworking() const override;
 	virtual bool IsNameStableForNetworking() const override;
 	//UObject
@@ -46,6 +201,33 @@ public:
 	bool IsLocallyControlled() const;
 	bool HasAuthority() const;
 
+	float GetSendInterval() const { return 1.0f / static_cast<float>(FMath::Max(NumberOfReplicationsPerSecond, 1)); }
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 1))
+	int32 NumberOfReplicationsPerSecond = 10;
+
+	//How long the value has to stay the same before we stop ticking and sending.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0.0))
+	float SleepAfterDuration = 1.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	EFGSmoothReplicatorMode SmoothMode = EFGSmoothReplicatorMode::ConstantVelocity;
+
+	//How far past the last crumb we keep going before holding still, LinearExtrapolation only.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0.0, EditCondition = "SmoothMode == EFGSmoothReplicatorMode::LinearExtrapolation"))
+	float MaxExtrapolationTime = 0.25f;
+
+	//Roughly how long it takes to catch up with a new crumb, CriticallyDampedSpring only.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0.01, EditCondition = "SmoothMode == EFGSmoothReplicatorMode::CriticallyDampedSpring"))
+	float SpringSmoothTime = 0.15f;
+
+	UPROPERTY(BlueprintAssignable)
+	FFGOnSmoothValueReplicationChanged OnValueChanged;
+
+protected:
+
+	void BroadcastDelegate();
+
 private:
 
 	bool bShouldTick = false;
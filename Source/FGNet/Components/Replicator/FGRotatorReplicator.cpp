@@ -0,0 +1,53 @@
+#include "FGRotatorReplicator.h"
+#include "Net/UnrealNetwork.h"
+
+void UFGRotatorReplicator::Tick(float DeltaTime)
+{
+	if (Smoothing.Tick(*this, DeltaTime))
+	{
+		BroadcastDelegate();
+	}
+}
+
+void UFGRotatorReplicator::Init()
+{
+	Smoothing.Init(*this);
+}
+
+void UFGRotatorReplicator::SetValue(const FRotator& InValue)
+{
+	if (Smoothing.SetValue(*this, InValue))
+	{
+		BroadcastDelegate();
+	}
+}
+
+FRotator UFGRotatorReplicator::GetValue() const
+{
+	return Smoothing.GetValue();
+}
+
+void UFGRotatorReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedRotator TerminalValue)
+{
+	Multicast_SendTerminalValue(SyncTag, TerminalValue);
+}
+
+void UFGRotatorReplicator::Server_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue)
+{
+	Multicast_SendReplicatedValue(SyncTag, ReplicatedValue);
+}
+
+void UFGRotatorReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue)
+{
+	Smoothing.ReceiveTerminalValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+void UFGRotatorReplicator::Multicast_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue)
+{
+	Smoothing.ReceiveValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+bool UFGRotatorReplicator::ShouldTick() const
+{
+	return Smoothing.ShouldTick();
+}
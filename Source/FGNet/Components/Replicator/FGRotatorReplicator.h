@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+#include "FGSmoothReplicator.h"
+#include "FGNetQuantize.h"
+#include "FGRotatorReplicator.generated.h"
+
+UCLASS()
+class FGNET_API UFGRotatorReplicator : public UFGReplicatorBase
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void Init() override;
+
+	UFUNCTION(Server, Reliable)
+	void Server_SendTerminalValue(int32 SyncTag, FFGNetQuantizedRotator TerminalValue);
+
+	UFUNCTION(Server, Unreliable)
+	void Server_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_SendTerminalValue(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedRotator ReplicatedValue);
+
+	UFUNCTION(BlueprintCallable, Category = Network)
+	void SetValue(const FRotator& InValue);
+
+	UFUNCTION(BlueprintPure, Category = Network)
+	FRotator GetValue() const;
+
+	bool ShouldTick() const;
+
+private:
+
+	TFGSmoothReplicator<FRotator, FFGNetQuantizedRotator> Smoothing = TFGSmoothReplicator<FRotator, FFGNetQuantizedRotator>(FRotator::ZeroRotator);
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+#include "FGSmoothReplicatorTrail.h"
+
+//Everything the typed replicators do besides declaring their RPCs. The replicator owns one of these and forwards to it,
+//ReplicatorType has to provide Server_ and Multicast_ SendReplicatedValue and SendTerminalValue taking a WireType.
+//Returns tell the replicator when to broadcast, that is protected on UFGReplicatorBase.
+template<typename ValueType, typename WireType>
+class TFGSmoothReplicator
+{
+public:
+
+	explicit TFGSmoothReplicator(const ValueType& InitialValue)
+		: Trail(InitialValue)
+	{}
+
+	void Init(UFGReplicatorBase& Replicator)
+	{
+		Trail.Init();
+		Replicator.SetShouldTick(false);
+	}
+
+	//Returns true if the value changed on a receiver.
+	template<typename ReplicatorType>
+	bool Tick(ReplicatorType& Replicator, float DeltaTime)
+	{
+		bool bValueChanged = false;
+
+		if (Replicator.IsLocallyControlled())
+		{
+			int32 SyncTag = 0;
+
+			switch (Trail.TickSender(DeltaTime, Replicator, SyncTag))
+			{
+			case EFGSmoothReplicatorSend::Value:
+				if (Replicator.HasAuthority())
+				{
+					Replicator.Multicast_SendReplicatedValue(SyncTag, WireType(Trail.GetValue()));
+				}
+
+				else
+				{
+					Replicator.Server_SendReplicatedValue(SyncTag, WireType(Trail.GetValue()));
+				}
+				break;
+			case EFGSmoothReplicatorSend::Terminal:
+				if (Replicator.HasAuthority())
+				{
+					Replicator.Multicast_SendTerminalValue(SyncTag, WireType(Trail.GetValue()));
+				}
+
+				else
+				{
+					Replicator.Server_SendTerminalValue(SyncTag, WireType(Trail.GetValue()));
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		else
+		{
+			bValueChanged = Trail.TickReceiver(DeltaTime, Replicator);
+		}
+
+		Replicator.SetShouldTick(ShouldTick());
+		return bValueChanged;
+	}
+
+	//Returns true if the value changed.
+	bool SetValue(UFGReplicatorBase& Replicator, const ValueType& InValue)
+	{
+		if (!Trail.SetValue(InValue))
+		{
+			return false;
+		}
+
+		if (Replicator.IsLocallyControlled() && Trail.IsSleeping())
+		{
+			Trail.WakeUp(Replicator.GetSendInterval());
+			Replicator.SetShouldTick(true);
+		}
+
+		return true;
+	}
+
+	ValueType GetValue() const
+	{
+		return Trail.GetValue();
+	}
+
+	void ReceiveValue(UFGReplicatorBase& Replicator, int32 SyncTag, const ValueType& ReplicatedValue)
+	{
+		if (Replicator.IsLocallyControlled())
+		{
+			return;
+		}
+
+		Trail.ReceiveValue(SyncTag, ReplicatedValue);
+		Replicator.SetShouldTick(ShouldTick());
+	}
+
+	void ReceiveTerminalValue(UFGReplicatorBase& Replicator, int32 SyncTag, const ValueType& ReplicatedValue)
+	{
+		if (Replicator.IsLocallyControlled())
+		{
+			return;
+		}
+
+		Trail.ReceiveTerminalValue(SyncTag, ReplicatedValue);
+		Replicator.SetShouldTick(ShouldTick());
+	}
+
+	bool ShouldTick() const
+	{
+		return !Trail.IsSleeping();
+	}
+
+private:
+
+	TFGSmoothReplicatorTrail<ValueType> Trail;
+};
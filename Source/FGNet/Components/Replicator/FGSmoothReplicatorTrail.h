@@ -0,0 +1,301 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+
+enum class EFGSmoothReplicatorSend : uint8
+{
+	None,
+	Value,
+	Terminal
+};
+
+//Sender and receiver state shared by all smooth replicators, the owning replicator does the actual RPCs.
+template<typename ValueType>
+struct TFGSmoothReplicatorTrail
+{
+	struct FCrumb
+	{
+		ValueType Value;
+	};
+
+	//Crumbs we keep before we start dropping the oldest ones, matches the inline allocation below.
+	static constexpr int32 MaxCrumbs = 10;
+
+	//If we are this many crumbs behind we speed up playback to catch up.
+	static constexpr int32 CatchUpCrumbs = 3;
+
+	TFGSmoothReplicatorTrail(const ValueType& InitialValue)
+		: ReplicatedValuePrevious(InitialValue)
+		, ReplicatedValueStart(InitialValue)
+		, ReplicatedValueTarget(InitialValue)
+		, ReplicatedValueCurrent(InitialValue)
+		, ReplicatedValuePerviouslySent(InitialValue)
+	{}
+
+	void Init()
+	{
+		bIsSleeping = true;
+		bHasSentTerminalValue = true;
+		bHasRevievedTerminalValue = true;
+	}
+
+	//Returns true if the value changed.
+	bool SetValue(const ValueType& InValue)
+	{
+		if (ReplicatedValueCurrent == InValue)
+		{
+			return false;
+		}
+
+		ReplicatedValueCurrent = InValue;
+		StaticValueTimer = 0.0f;
+		return true;
+	}
+
+	EFGSmoothReplicatorSend TickSender(float DeltaTime, const UFGReplicatorBase& Settings, int32& OutSyncTag)
+	{
+		if (bIsSleeping)
+		{
+			return EFGSmoothReplicatorSend::None;
+		}
+
+		const float SendInterval = Settings.GetSendInterval();
+
+		SyncTimer += DeltaTime;
+
+		if (SyncTimer < SendInterval)
+		{
+			return EFGSmoothReplicatorSend::None;
+		}
+
+		//Never send more than once per frame, even if we had a long hitch.
+		SyncTimer = FMath::Fmod(SyncTimer, SendInterval);
+
+		if (ReplicatedValueCurrent != ReplicatedValuePerviouslySent)
+		{
+			OutSyncTag = NextSyncTag++;
+			ReplicatedValuePerviouslySent = ReplicatedValueCurrent;
+			bHasSentTerminalValue = false;
+			StaticValueTimer = 0.0f;
+			return EFGSmoothReplicatorSend::Value;
+		}
+
+		EFGSmoothReplicatorSend Result = EFGSmoothReplicatorSend::None;
+
+		if (!bHasSentTerminalValue)
+		{
+			OutSyncTag = NextSyncTag++;
+			bHasSentTerminalValue = true;
+			Result = EFGSmoothReplicatorSend::Terminal;
+		}
+
+		StaticValueTimer += SendInterval;
+
+		if (StaticValueTimer >= Settings.SleepAfterDuration)
+		{
+			GoToSleep();
+		}
+
+		return Result;
+	}
+
+	//Returns true if the value changed.
+	bool TickReceiver(float DeltaTime, const UFGReplicatorBase& Settings)
+	{
+		const ValueType PreviousValue = ReplicatedValueCurrent;
+
+		if (Settings.SmoothMode == EFGSmoothReplicatorMode::CriticallyDampedSpring)
+		{
+			TickSpring(DeltaTime, Settings);
+			return PreviousValue != ReplicatedValueCurrent;
+		}
+
+		//Play back faster if we have fallen behind, otherwise we would keep the extra delay forever.
+		LerpSpeed = CrumbTrail.Num() > CatchUpCrumbs ? static_cast<float>(CrumbTrail.Num()) / static_cast<float>(CatchUpCrumbs) : 1.0f;
+
+		float TimeLeft = DeltaTime * LerpSpeed;
+
+		while (TimeLeft > 0.0f)
+		{
+			if (CurrentCrumbTimeRemaining <= 0.0f)
+			{
+				if (CrumbTrail.Num() == 0)
+				{
+					if (Settings.SmoothMode == EFGSmoothReplicatorMode::LinearExtrapolation && !bHasRevievedTerminalValue)
+					{
+						Extrapolate(TimeLeft, Settings.MaxExtrapolationTime);
+					}
+
+					break;
+				}
+
+				StartNextCrumb(Settings.GetSendInterval());
+			}
+
+			const float Step = FMath::Min(TimeLeft, CurrentCrumbTimeRemaining);
+			const float StepAlpha = Step / CurrentCrumbTimeRemaining;
+
+			CurrentCrumbTimeRemaining -= Step;
+			TimeLeft -= Step;
+
+			const float SegmentAlpha = 1.0f - CurrentCrumbTimeRemaining / CurrentCrumbDuration;
+
+			switch (Settings.SmoothMode)
+			{
+			case EFGSmoothReplicatorMode::Hermite:
+				ReplicatedValueCurrent = TFGSmoothReplicatorOperation<ValueType>::InterpHermite(ReplicatedValuePrevious, ReplicatedValueStart, ReplicatedValueTarget, CrumbTrail.Num() > 0 ? CrumbTrail[0].Value : ReplicatedValueTarget, SegmentAlpha);
+				break;
+			case EFGSmoothReplicatorMode::LinearExtrapolation:
+				ReplicatedValueCurrent = TFGSmoothReplicatorOperation<ValueType>::LerpUnclamped(ReplicatedValueStart, ReplicatedValueTarget, SegmentAlpha);
+				break;
+			case EFGSmoothReplicatorMode::ConstantVelocity:
+			default:
+				TFGSmoothReplicatorOperation<ValueType>::InterpConstantVelocity(ReplicatedValueCurrent, ReplicatedValueTarget, StepAlpha);
+				break;
+			}
+		}
+
+		if (CurrentCrumbTimeRemaining <= 0.0f && CrumbTrail.Num() == 0 && bHasRevievedTerminalValue)
+		{
+			GoToSleep();
+		}
+
+		return PreviousValue != ReplicatedValueCurrent;
+	}
+
+	void ReceiveValue(int32 SyncTag, const ValueType& InValue)
+	{
+		//Unreliable, so drop anything that arrives out of order.
+		if (SyncTag <= LastRecievedCrumbSyncTag)
+		{
+			return;
+		}
+
+		LastRecievedSyncTag = FMath::Max(LastRecievedSyncTag, SyncTag);
+		AddCrumb(SyncTag, InValue);
+		bHasRevievedTerminalValue = false;
+	}
+
+	void ReceiveTerminalValue(int32 SyncTag, const ValueType& InValue)
+	{
+		LastRecievedSyncTag = FMath::Max(LastRecievedSyncTag, SyncTag);
+
+		//A newer unreliable crumb beat the terminal value here, that one wins.
+		if (SyncTag < LastRecievedCrumbSyncTag)
+		{
+			return;
+		}
+
+		AddCrumb(SyncTag, InValue);
+		bHasRevievedTerminalValue = true;
+	}
+
+	void GoToSleep()
+	{
+		bIsSleeping = true;
+		StaticValueTimer = 0.0f;
+		SyncTimer = 0.0f;
+	}
+
+	void WakeUp(float SendInterval)
+	{
+		bIsSleeping = false;
+		CurrentCrumbTimeRemaining = 0.0f;
+
+		//Let the first change go out on the next tick instead of waiting a full interval.
+		SyncTimer = SendInterval;
+	}
+
+	bool IsSleeping() const { return bIsSleeping; }
+
+	const ValueType& GetValue() const { return ReplicatedValueCurrent; }
+
+private:
+
+	void AddCrumb(int32 SyncTag, const ValueType& InValue)
+	{
+		if (CrumbTrail.Num() >= MaxCrumbs)
+		{
+			CrumbTrail.RemoveAt(0, 1, false);
+		}
+
+		FCrumb Crumb;
+		Crumb.Value = InValue;
+		CrumbTrail.Add(Crumb);
+
+		LastRecievedCrumbSyncTag = SyncTag;
+
+		if (bIsSleeping)
+		{
+			bIsSleeping = false;
+			CurrentCrumbTimeRemaining = 0.0f;
+		}
+	}
+
+	void StartNextCrumb(float SendInterval)
+	{
+		//Start from where we are, not the previous crumb, in case we extrapolated past it.
+		ReplicatedValuePrevious = ReplicatedValueStart;
+		ReplicatedValueStart = ReplicatedValueCurrent;
+		ReplicatedValueTarget = CrumbTrail[0].Value;
+		CrumbTrail.RemoveAt(0, 1, false);
+		CurrentCrumbDuration = SendInterval;
+		CurrentCrumbTimeRemaining = SendInterval;
+		ExtrapolationTime = 0.0f;
+	}
+
+	void Extrapolate(float DeltaTime, float MaxExtrapolationTime)
+	{
+		if (ExtrapolationTime >= MaxExtrapolationTime || CurrentCrumbDuration <= 0.0f)
+		{
+			return;
+		}
+
+		ExtrapolationTime = FMath::Min(ExtrapolationTime + DeltaTime, MaxExtrapolationTime);
+		ReplicatedValueCurrent = TFGSmoothReplicatorOperation<ValueType>::LerpUnclamped(ReplicatedValueStart, ReplicatedValueTarget, 1.0f + ExtrapolationTime / CurrentCrumbDuration);
+	}
+
+	//The spring ignores pacing and always chases the newest crumb.
+	void TickSpring(float DeltaTime, const UFGReplicatorBase& Settings)
+	{
+		if (CrumbTrail.Num() > 0)
+		{
+			ReplicatedValueTarget = CrumbTrail.Last().Value;
+			CrumbTrail.Reset();
+		}
+
+		Spring.Step(ReplicatedValueCurrent, ReplicatedValueTarget, Settings.SpringSmoothTime, DeltaTime);
+
+		if (bHasRevievedTerminalValue && TFGSmoothReplicatorOperation<ValueType>::IsNearlyEqual(ReplicatedValueCurrent, ReplicatedValueTarget))
+		{
+			ReplicatedValueCurrent = ReplicatedValueTarget;
+			Spring.Reset();
+			GoToSleep();
+		}
+	}
+
+	TArray<FCrumb, TInlineAllocator<10>> CrumbTrail;
+
+	TFGSmoothReplicatorSpring<ValueType> Spring;
+
+	ValueType ReplicatedValuePrevious;
+	ValueType ReplicatedValueStart;
+	ValueType ReplicatedValueTarget;
+	ValueType ReplicatedValueCurrent;
+	ValueType ReplicatedValuePerviouslySent;
+	float StaticValueTimer = 0.0f;
+
+	int32 NextSyncTag = 0;
+	int32 LastRecievedSyncTag = -1;
+	int32 LastRecievedCrumbSyncTag = -1;
+
+	float SyncTimer = 0.0f;
+	float LerpSpeed = 0.0f;
+	float CurrentCrumbTimeRemaining = 0.0f;
+	float CurrentCrumbDuration = 0.0f;
+	float ExtrapolationTime = 0.0f;
+
+	bool bHasRevievedTerminalValue = false;
+	bool bHasSentTerminalValue = false;
+	bool bIsSleeping = false;
+};
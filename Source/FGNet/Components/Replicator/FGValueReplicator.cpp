@@ -3,55 +3,51 @@
 
 void UFGValueReplicator::Tick(float DeltaTime)
 {
-
+	if (Smoothing.Tick(*this, DeltaTime))
+	{
+		BroadcastDelegate();
+	}
 }
 
 void UFGValueReplicator::Init()
 {
-	bIsSleeping = true;
-	bHasSentTerminalValue = true;
-	bHasRevievedTerminalValue = true;
+	Smoothing.Init(*this);
 }
 
 void UFGValueReplicator::SetValue(float InValue)
 {
-
+	if (Smoothing.SetValue(*this, InValue))
+	{
+		BroadcastDelegate();
+	}
 }
 
-//float UFGValueReplicator::GetValue()
-//{
-//	return ReplicatedValueCurrent;
-//}
-
-//void UFGValueReplicator::BroadcastDelegate()
-//{
-//	if (OnValueChanged.IsBound())
-//	{
-//		OnValueChanged.Broadcast();
-//	}
-//}
+float UFGValueReplicator::GetValue() const
+{
+	return Smoothing.GetValue();
+}
 
 void UFGValueReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag, float TerminalValue)
 {
-
+	Multicast_SendTerminalValue(SyncTag, TerminalValue);
 }
 
 void UFGValueReplicator::Server_SendReplicatedValue_Implementation(int32 SyncTag, float ReplicatedValue)
 {
-
+	Multicast_SendReplicatedValue(SyncTag, ReplicatedValue);
 }
 
 void UFGValueReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTag, float ReplicatedValue)
 {
-
+	Smoothing.ReceiveTerminalValue(*this, SyncTag, ReplicatedValue);
 }
 
 void UFGValueReplicator::Multicast_SendReplicatedValue_Implementation(int32 SyncTag, float ReplicatedValue)
 {
-
+	Smoothing.ReceiveValue(*this, SyncTag, ReplicatedValue);
 }
 
-bool UFGValueReplicator::ShouldTick() const 
+bool UFGValueReplicator::ShouldTick() const
 {
-	return true;
-}
\ No newline at end of file
+	return Smoothing.ShouldTick();
+}
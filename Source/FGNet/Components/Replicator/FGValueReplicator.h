@@ -1,10 +1,9 @@
 #pragma once
 
 #include "FGReplicatorBase.h"
+#include "FGSmoothReplicator.h"
 #include "FGValueReplicator.generated.h"
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFGOnSmoothValueReplicationChanged);
-
 UCLASS()
 class FGNET_API UFGValueReplicator : public UFGReplicatorBase
 {
@@ -31,46 +30,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Network)
 	void SetValue(float InValue);
 
-	//UFUNCTION(BlueprintPure, Category = Network)
-	//float GetValue() const;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 1))
-	int32 NumberOfReplicationsPerSecond = 10;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere)
-	EFGSmoothReplicatorMode SmoothMode = EFGSmoothReplicatorMode::ConstantVelocity;
-
-	//UPROPERTY(BlueprintAssignable)
-	//FFGOnSmoothValuereplicationChanged OnValueChanged;
+	UFUNCTION(BlueprintPure, Category = Network)
+	float GetValue() const;
 
 	bool ShouldTick() const;
 
 private:
 
-	void BroadcastDelegate();
-
-	struct FCrumb
-	{
-		float Value;
-	};
-
-	TArray<FCrumb, TInlineAllocator<10>> CrumbTrail;
-
-	float ReplicatedValueTarget = 0.0f;
-	float ReplicatedValueCurrent = 0.0f;
-	float ReplicatedValuePerviouslySent = 0.0f;
-	float StaticValueTimer = 0.0f;
-	float SleepAfterDuration = 1.0f;
-
-	int32 NextSyncTag = 0;
-	int32 LastRecievedSyncTag = -1;
-	int32 LastRecievedCrumbSyncTag = -1;
-
-	float SyncTimer = 0.0f;
-	float LerpSpeed = 0.0f;
-	float CurrentCrumbTimeRemaining = 0.0f;
-
-	bool bHasRevievedTerminalValue = false;
-	bool bHasSentTerminalValue = false;
-	bool bIsSleeping = false;
-};
\ No newline at end of file
+	TFGSmoothReplicator<float, float> Smoothing = TFGSmoothReplicator<float, float>(0.0f);
+};
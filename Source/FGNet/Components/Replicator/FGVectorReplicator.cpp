@@ -0,0 +1,53 @@
+#include "FGVectorReplicator.h"
+#include "Net/UnrealNetwork.h"
+
+void UFGVectorReplicator::Tick(float DeltaTime)
+{
+	if (Smoothing.Tick(*this, DeltaTime))
+	{
+		BroadcastDelegate();
+	}
+}
+
+void UFGVectorReplicator::Init()
+{
+	Smoothing.Init(*this);
+}
+
+void UFGVectorReplicator::SetValue(const FVector& InValue)
+{
+	if (Smoothing.SetValue(*this, InValue))
+	{
+		BroadcastDelegate();
+	}
+}
+
+FVector UFGVectorReplicator::GetValue() const
+{
+	return Smoothing.GetValue();
+}
+
+void UFGVectorReplicator::Server_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedVector TerminalValue)
+{
+	Multicast_SendTerminalValue(SyncTag, TerminalValue);
+}
+
+void UFGVectorReplicator::Server_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue)
+{
+	Multicast_SendReplicatedValue(SyncTag, ReplicatedValue);
+}
+
+void UFGVectorReplicator::Multicast_SendTerminalValue_Implementation(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue)
+{
+	Smoothing.ReceiveTerminalValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+void UFGVectorReplicator::Multicast_SendReplicatedValue_Implementation(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue)
+{
+	Smoothing.ReceiveValue(*this, SyncTag, ReplicatedValue.Value);
+}
+
+bool UFGVectorReplicator::ShouldTick() const
+{
+	return Smoothing.ShouldTick();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FGReplicatorBase.h"
+#include "FGSmoothReplicator.h"
+#include "FGNetQuantize.h"
+#include "FGVectorReplicator.generated.h"
+
+UCLASS()
+class FGNET_API UFGVectorReplicator : public UFGReplicatorBase
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void Init() override;
+
+	UFUNCTION(Server, Reliable)
+	void Server_SendTerminalValue(int32 SyncTag, FFGNetQuantizedVector TerminalValue);
+
+	UFUNCTION(Server, Unreliable)
+	void Server_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_SendTerminalValue(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_SendReplicatedValue(int32 SyncTag, FFGNetQuantizedVector ReplicatedValue);
+
+	UFUNCTION(BlueprintCallable, Category = Network)
+	void SetValue(const FVector& InValue);
+
+	UFUNCTION(BlueprintPure, Category = Network)
+	FVector GetValue() const;
+
+	bool ShouldTick() const;
+
+private:
+
+	TFGSmoothReplicator<FVector, FFGNetQuantizedVector> Smoothing = TFGSmoothReplicator<FVector, FFGNetQuantizedVector>(FVector::ZeroVector);
+};
@@ -0,0 +1,434 @@
+#include "FGLoadTestSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "../FGNet.h"
+#include "../FGPickup.h"
+#include "../FGRocketSubsystem.h"
+#include "../Player/FGPlayer.h"
+#include "FGPredictionBenchmarkSubsystem.h"
+
+//Time the benchmark bots get to start up and join on top of running their profiles.
+const static float BenchmarkStartupTime = 60.0f;
+
+//How far ahead the benchmark bots are told to start, the start time has to reach them before it passes.
+const static float BenchmarkStartDelay = 5.0f;
+
+//Every interval has one row for the whole server, Connection is All, followed by one row per connection that only
+//fills in the columns that are about that connection.
+static const TCHAR* LoadTestReportHeader = TEXT("Time,Connection,NumBots,NumConnections,FrameTimeMean,FrameTimeP99,FrameTimeMax,MemoryUsedMB,InBytesPerSecond,OutBytesPerSecond,OutBytesPerSecondPerConnection,MaxOutBytesPerSecondPerConnection,Ping,OutLoss\n");
+
+void UFGLoadTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (IsRunningDedicatedServer() && FParse::Param(FCommandLine::Get(), TEXT("FGNetPredictionBenchmark")))
+	{
+		//The scripted two player session of the prediction benchmark, the bots measure and judge it themselves.
+		bIsServer = true;
+		bIsBenchmark = true;
+		NumBots = 2;
+		Duration = GetDefault<UFGPredictionBenchmarkSubsystem>()->GetTotalDuration() + BenchmarkStartupTime;
+		BotArguments += TEXT(" -FGNetPredictionBenchmark");
+
+		if (FParse::Param(FCommandLine::Get(), TEXT("FGNetPredictionBaselineUpdate")))
+		{
+			BotArguments += TEXT(" -FGNetPredictionBaselineUpdate");
+		}
+
+		FString OnlyProfile;
+
+		if (FParse::Value(FCommandLine::Get(), TEXT("FGNetPredictionProfile="), OnlyProfile))
+		{
+			BotArguments += FString::Printf(TEXT(" -FGNetPredictionProfile=%s"), *OnlyProfile);
+		}
+
+		UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark, giving up after %.0f seconds"), Duration);
+	}
+
+	else if (IsRunningDedicatedServer() && FParse::Value(FCommandLine::Get(), TEXT("FGNetLoadTest="), NumBots) && NumBots > 0)
+	{
+		bIsServer = true;
+		Duration = DefaultDuration;
+		FParse::Value(FCommandLine::Get(), TEXT("FGNetLoadTestDuration="), Duration);
+
+		UE_LOG(LogFGNet, Display, TEXT("Load test with %d bots for %.0f seconds"), NumBots, Duration);
+	}
+
+	else if (FParse::Param(FCommandLine::Get(), TEXT("FGNetBot")))
+	{
+		bIsBot = true;
+
+		FParse::Value(FCommandLine::Get(), TEXT("FGNetBotSeed="), BotSeed);
+		BotRandom.Initialize(BotSeed);
+	}
+}
+
+void UFGLoadTestSubsystem::Deinitialize()
+{
+	for (FProcHandle& BotProcess : BotProcesses)
+	{
+		if (FPlatformProcess::IsProcRunning(BotProcess))
+		{
+			FPlatformProcess::TerminateProc(BotProcess, true);
+		}
+
+		FPlatformProcess::CloseProc(BotProcess);
+	}
+
+	BotProcesses.Reset();
+
+	if (ReportWriter != nullptr)
+	{
+		ReportWriter->Close();
+		delete ReportWriter;
+		ReportWriter = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+void UFGLoadTestSubsystem::Tick(float DeltaTime)
+{
+	if (bIsServer)
+	{
+		TickServer(DeltaTime);
+	}
+
+	else
+	{
+		TickBot(DeltaTime);
+	}
+}
+
+bool UFGLoadTestSubsystem::IsTickable() const
+{
+	return (bIsServer || bIsBot) && GetTickableGameObjectWorld() != nullptr && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGLoadTestSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+UWorld* UFGLoadTestSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetGameInstance()->GetWorld();
+}
+
+void UFGLoadTestSubsystem::TickServer(float DeltaTime)
+{
+	//Bots can only connect once the server listens.
+	if (GetTickableGameObjectWorld()->GetNetDriver() == nullptr)
+	{
+		return;
+	}
+
+	TestTime += DeltaTime;
+	TimeSinceReport += DeltaTime;
+	FrameTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	if (BotProcesses.Num() < NumBots)
+	{
+		LaunchBudget += BotsLaunchedPerSecond * DeltaTime;
+
+		while (LaunchBudget >= 1.0f && BotProcesses.Num() < NumBots)
+		{
+			LaunchBudget -= 1.0f;
+			LaunchBot();
+		}
+	}
+
+	if (bIsBenchmark && !bHasStartedBenchmark)
+	{
+		StartBenchmark();
+	}
+
+	if (TimeSinceReport >= ReportInterval)
+	{
+		WriteReport(TimeSinceReport, false);
+		TimeSinceReport = 0.0f;
+	}
+
+	if (bIsBenchmark && BotProcesses.Num() == NumBots)
+	{
+		bool bBotsRunning = false;
+		bool bBotsPassed = true;
+
+		for (FProcHandle& BotProcess : BotProcesses)
+		{
+			int32 ReturnCode = 0;
+
+			if (FPlatformProcess::IsProcRunning(BotProcess))
+			{
+				bBotsRunning = true;
+			}
+
+			else if (!FPlatformProcess::GetProcReturnCode(BotProcess, &ReturnCode) || ReturnCode != 0)
+			{
+				bBotsPassed = false;
+			}
+		}
+
+		if (!bBotsRunning)
+		{
+			UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark %s"), bBotsPassed ? TEXT("passed") : TEXT("failed"));
+			WriteReport(TimeSinceReport, true);
+			bIsServer = false;
+			FPlatformMisc::RequestExitWithStatus(false, bBotsPassed ? 0 : 1);
+			return;
+		}
+	}
+
+	if (TestTime >= Duration)
+	{
+		if (bIsBenchmark)
+		{
+			UE_LOG(LogFGNet, Error, TEXT("Prediction benchmark timed out"));
+		}
+
+		WriteReport(TimeSinceReport, true);
+		bIsServer = false;
+		FPlatformMisc::RequestExitWithStatus(false, bIsBenchmark ? 1 : 0);
+	}
+}
+
+void UFGLoadTestSubsystem::TickBot(float DeltaTime)
+{
+	AFGPlayer* Player = BotPlayer.Get();
+
+	if (Player == nullptr)
+	{
+		APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController(GetTickableGameObjectWorld());
+		Player = PlayerController != nullptr ? PlayerController->GetPawn<AFGPlayer>() : nullptr;
+
+		if (Player == nullptr)
+		{
+			return;
+		}
+
+		//Nobody is pressing anything, the bound axes would zero our input every frame.
+		Player->DisableInput(PlayerController);
+		BotPlayer = Player;
+		TimeUntilRetarget = 0.0f;
+		TimeUntilFire = BotRandom.FRandRange(BotFireInterval.X, BotFireInterval.Y);
+	}
+
+	TimeUntilRetarget -= DeltaTime;
+
+	if (TimeUntilRetarget <= 0.0f || FVector::DistSquared2D(Player->GetActorLocation(), BotTarget) < FMath::Square(200.0f))
+	{
+		BotTarget = PickBotTarget(Player);
+		TimeUntilRetarget = BotRetargetInterval;
+	}
+
+	//Steer at the target, brake into turns that are too sharp to make at speed.
+	const FVector ToTarget = (BotTarget - Player->GetActorLocation()).GetSafeNormal2D();
+	const FVector Facing = Player->GetActorForwardVector().GetSafeNormal2D();
+	const float Side = FVector::CrossProduct(Facing, ToTarget).Z;
+	const float Ahead = FVector::DotProduct(Facing, ToTarget);
+
+	Player->SetScriptedInput(Ahead > -0.5f ? 1.0f : 0.25f, FMath::Clamp(Side * 3.0f, -1.0f, 1.0f), Ahead < 0.0f);
+
+	TimeUntilFire -= DeltaTime;
+
+	if (TimeUntilFire <= 0.0f)
+	{
+		Player->FireRocket();
+		TimeUntilFire = BotRandom.FRandRange(BotFireInterval.X, BotFireInterval.Y);
+	}
+}
+
+void UFGLoadTestSubsystem::RestartBot(int32 Run)
+{
+	if (!bIsBot)
+	{
+		return;
+	}
+
+	BotRandom.Initialize(static_cast<int32>(HashCombine(GetTypeHash(BotSeed), GetTypeHash(Run))));
+	TimeUntilRetarget = 0.0f;
+	TimeUntilFire = BotRandom.FRandRange(BotFireInterval.X, BotFireInterval.Y);
+}
+
+void UFGLoadTestSubsystem::StartBenchmark()
+{
+	const UWorld* World = GetTickableGameObjectWorld();
+	const UFGRocketSubsystem* RocketSubsystem = World->GetSubsystem<UFGRocketSubsystem>();
+	TArray<AFGPlayer*, TInlineAllocator<2>> Players;
+
+	for (const UNetConnection* Connection : World->GetNetDriver()->ClientConnections)
+	{
+		AFGPlayer* Player = Connection != nullptr && Connection->PlayerController != nullptr ? Connection->PlayerController->GetPawn<AFGPlayer>() : nullptr;
+
+		if (Player != nullptr)
+		{
+			Players.Add(Player);
+		}
+	}
+
+	//The bots measure each other, neither starts before both are in.
+	if (RocketSubsystem == nullptr || Players.Num() < NumBots)
+	{
+		return;
+	}
+
+	const float StartTime = RocketSubsystem->GetServerWorldTime() + BenchmarkStartDelay;
+
+	for (AFGPlayer* Player : Players)
+	{
+		Player->Client_StartPredictionBenchmark(StartTime);
+	}
+
+	bHasStartedBenchmark = true;
+	UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark starts at server time %.1f"), StartTime);
+}
+
+void UFGLoadTestSubsystem::LaunchBot()
+{
+	const int32 BotIndex = BotProcesses.Num();
+	const FString Executable = BotExecutable.IsEmpty() ? FString(FPlatformProcess::ExecutablePath()) : BotExecutable;
+
+	FString Arguments;
+
+#if WITH_EDITOR
+	//The editor executable needs to be told which project to run.
+	Arguments = FString::Printf(TEXT("\"%s\" "), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
+#endif
+
+	Arguments += FString::Printf(TEXT("127.0.0.1:%d %s -FGNetBot -FGNetBotSeed=%d -log=FGNetBot%d.log"), GetTickableGameObjectWorld()->URL.Port, *BotArguments, BotIndex, BotIndex);
+
+	FProcHandle BotProcess = FPlatformProcess::CreateProc(*Executable, *Arguments, true, true, true, nullptr, 0, nullptr, nullptr);
+
+	if (!BotProcess.IsValid())
+	{
+		UE_LOG(LogFGNet, Error, TEXT("Could not launch bot %d: %s %s"), BotIndex, *Executable, *Arguments);
+		NumBots = BotProcesses.Num();
+		return;
+	}
+
+	BotProcesses.Add(BotProcess);
+}
+
+void UFGLoadTestSubsystem::WriteReport(float Elapsed, bool bSummary)
+{
+	const UNetDriver* NetDriver = GetTickableGameObjectWorld()->GetNetDriver();
+	int32 NumConnections = 0;
+	int64 InBytesPerSecond = 0;
+	int64 OutBytesPerSecond = 0;
+	int32 MaxOutBytesPerSecond = 0;
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection != nullptr)
+		{
+			NumConnections++;
+			InBytesPerSecond += Connection->InBytesPerSecond;
+			OutBytesPerSecond += Connection->OutBytesPerSecond;
+			MaxOutBytesPerSecond = FMath::Max(MaxOutBytesPerSecond, Connection->OutBytesPerSecond);
+		}
+	}
+
+	float FrameTimeMean = 0.0f;
+	float FrameTimeP99 = 0.0f;
+	float FrameTimeMax = 0.0f;
+
+	if (FrameTimes.Num() > 0)
+	{
+		FrameTimes.Sort();
+
+		for (float FrameTime : FrameTimes)
+		{
+			FrameTimeMean += FrameTime;
+		}
+
+		FrameTimeMean /= FrameTimes.Num();
+		FrameTimeP99 = FrameTimes[FMath::Min(FMath::FloorToInt(FrameTimes.Num() * 0.99f), FrameTimes.Num() - 1)];
+		FrameTimeMax = FrameTimes.Last();
+	}
+
+	PeakConnections = FMath::Max(PeakConnections, NumConnections);
+	WorstFrameTime = FMath::Max(WorstFrameTime, FrameTimeMax);
+	FrameTimes.Reset();
+
+	if (ReportWriter == nullptr)
+	{
+		const FString FileName = FPaths::Combine(FPaths::ProfilingDir(), TEXT("FGNet"), FString::Printf(TEXT("LoadTest-%d-%s.csv"), NumBots, *FDateTime::Now().ToString()));
+		ReportWriter = IFileManager::Get().CreateFileWriter(*FileName, FILEWRITE_AllowRead);
+
+		if (ReportWriter == nullptr)
+		{
+			UE_LOG(LogFGNet, Error, TEXT("Could not write load test report to %s"), *FileName);
+			return;
+		}
+
+		const FTCHARToUTF8 Header(LoadTestReportHeader);
+		ReportWriter->Serialize(const_cast<ANSICHAR*>(Header.Get()), Header.Length());
+		UE_LOG(LogFGNet, Display, TEXT("Writing load test report to %s"), *FileName);
+	}
+
+	FString Line = FString::Printf(TEXT("%.1f,All,%d,%d,%.2f,%.2f,%.2f,%.1f,%lld,%lld,%lld,%d,,\n"),
+		TestTime, BotProcesses.Num(), NumConnections, FrameTimeMean, FrameTimeP99, FrameTimeMax,
+		FPlatformMemory::GetStats().UsedPhysical / (1024.0f * 1024.0f), InBytesPerSecond, OutBytesPerSecond,
+		NumConnections > 0 ? OutBytesPerSecond / NumConnections : 0, MaxOutBytesPerSecond);
+
+	//The aggregate hides a single connection that gets starved or flooded.
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection == nullptr)
+		{
+			continue;
+		}
+
+		const int32 OutPackets = Connection->OutPacketsPerSecond;
+		const float OutLoss = OutPackets > 0 ? 100.0f * Connection->OutPacketsLost / OutPackets : 0.0f;
+
+		Line += FString::Printf(TEXT("%.1f,%s,,,,,,,%d,%d,%d,,%.1f,%.2f\n"),
+			TestTime, *Connection->LowLevelGetRemoteAddress(true), Connection->InBytesPerSecond, Connection->OutBytesPerSecond,
+			Connection->OutBytesPerSecond, Connection->AvgLag * 1000.0f, OutLoss);
+	}
+
+	const FTCHARToUTF8 Utf8Line(*Line);
+	ReportWriter->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+	ReportWriter->Flush();
+
+	if (bSummary)
+	{
+		UE_LOG(LogFGNet, Display, TEXT("Load test done: %d bots, peak %d connections, worst frame %.2f ms, %.1f MB peak memory"),
+			BotProcesses.Num(), PeakConnections, WorstFrameTime, FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0f * 1024.0f));
+	}
+}
+
+FVector UFGLoadTestSubsystem::PickBotTarget(const AFGPlayer* Player)
+{
+	const FVector Location = Player->GetActorLocation();
+	float ClosestDistanceSquared = BIG_NUMBER;
+	FVector Target = Location + FVector(BotRandom.FRandRange(-3000.0f, 3000.0f), BotRandom.FRandRange(-3000.0f, 3000.0f), 0.0f);
+
+	//Only now and then, so the bots do not all chase the same pickup.
+	if (BotRandom.FRand() < 0.5f)
+	{
+		return Target;
+	}
+
+	for (TActorIterator<AFGPickup> It(GetTickableGameObjectWorld()); It; ++It)
+	{
+		const float DistanceSquared = FVector::DistSquared2D(Location, It->GetActorLocation());
+
+		if (!It->GetIsPickedUp() && DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			Target = It->GetActorLocation();
+		}
+	}
+
+	return Target;
+}
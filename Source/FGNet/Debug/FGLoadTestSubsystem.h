@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "HAL/PlatformProcess.h"
+#include "FGLoadTestSubsystem.generated.h"
+
+class AFGPlayer;
+class FArchive;
+
+//Load test for the server. A dedicated server started with -FGNetLoadTest=<NumBots> launches that many bot clients as
+//child processes, records its frame time, memory and bandwidth to Saved/Profiling/FGNet, and quits after
+//-FGNetLoadTestDuration=<Seconds>. A client started with -FGNetBot drives its player with scripted input.
+//Bots run as separate processes because a single process cannot host more than one game client outside the editor.
+//With -FGNetPredictionBenchmark the server runs two bots for UFGPredictionBenchmarkSubsystem and quits with their verdict.
+UCLASS(Config = Game)
+class FGNET_API UFGLoadTestSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//FTickableGameObject
+
+	//Launched at this rate so the server is not hit by every login at once.
+	UPROPERTY(Config)
+	float BotsLaunchedPerSecond = 4.0f;
+
+	UPROPERTY(Config)
+	float ReportInterval = 5.0f;
+
+	//Used when the command line does not give a duration.
+	UPROPERTY(Config)
+	float DefaultDuration = 300.0f;
+
+	//Executable the bots run, this one when empty. A dedicated server build needs the client executable here.
+	UPROPERTY(Config)
+	FString BotExecutable;
+
+	UPROPERTY(Config)
+	FString BotArguments = TEXT("-game -nullrhi -nosound -nosplash -unattended");
+
+	//How often a bot picks a new place to drive to, in seconds.
+	UPROPERTY(Config)
+	float BotRetargetInterval = 4.0f;
+
+	UPROPERTY(Config)
+	FVector2D BotFireInterval = FVector2D(1.0f, 3.0f);
+
+	//Starts the bot's scripted input over, the same bot and run always make the same choices.
+	void RestartBot(int32 Run);
+
+private:
+
+	void TickServer(float DeltaTime);
+
+	void TickBot(float DeltaTime);
+
+	void LaunchBot();
+
+	//Tells the benchmark bots when to start once they have all joined.
+	void StartBenchmark();
+
+	void WriteReport(float Elapsed, bool bSummary);
+
+	//Closest pickup that can be collected, otherwise somewhere random around the bot.
+	FVector PickBotTarget(const AFGPlayer* Player);
+
+	bool bIsServer = false;
+
+	bool bIsBot = false;
+
+	bool bIsBenchmark = false;
+
+	bool bHasStartedBenchmark = false;
+
+	//Server.
+	int32 NumBots = 0;
+
+	float Duration = 0.0f;
+
+	float TestTime = 0.0f;
+
+	float TimeSinceReport = 0.0f;
+
+	float LaunchBudget = 0.0f;
+
+	TArray<FProcHandle> BotProcesses;
+
+	//Game thread work per frame in milliseconds, excluding the wait for the next tick.
+	TArray<float> FrameTimes;
+
+	int32 PeakConnections = 0;
+
+	float WorstFrameTime = 0.0f;
+
+	FArchive* ReportWriter = nullptr;
+
+	//Bot.
+	int32 BotSeed = 0;
+
+	FRandomStream BotRandom;
+
+	TWeakObjectPtr<AFGPlayer> BotPlayer;
+
+	FVector BotTarget = FVector::ZeroVector;
+
+	float TimeUntilRetarget = 0.0f;
+
+	float TimeUntilFire = 0.0f;
+};
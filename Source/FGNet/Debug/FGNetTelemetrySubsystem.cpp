@@ -0,0 +1,260 @@
+#include "FGNetTelemetrySubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+static const TCHAR* TelemetryLogHeader = TEXT("Time,Address,RttMean,RttStdDev,Jitter,InLoss,OutLoss,OutOfOrder,SnapCorrectionsPerSecond,PredictionCorrectionsPerSecond\n");
+
+void UFGNetTelemetrySubsystem::Deinitialize()
+{
+	if (LogWriter != nullptr)
+	{
+		LogWriter->Close();
+		delete LogWriter;
+		LogWriter = nullptr;
+	}
+
+	Connections.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGNetTelemetrySubsystem::Tick(float DeltaTime)
+{
+	TimeSinceSample += DeltaTime;
+
+	if (TimeSinceSample >= SampleInterval)
+	{
+		TakeSamples(TimeSinceSample);
+		TimeSinceSample = 0.0f;
+	}
+}
+
+bool UFGNetTelemetrySubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World != nullptr && World->GetNetDriver() != nullptr && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGNetTelemetrySubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGNetTelemetrySubsystem::AddRttSample(const UNetConnection* Connection, float Rtt)
+{
+	if (FConnectionState* State = FindState(Connection))
+	{
+		State->NumRttSamples++;
+		State->bIsRttMeasured = true;
+		const double Delta = Rtt - State->RttMean;
+		State->RttMean += Delta / State->NumRttSamples;
+		State->RttM2 += Delta * (Rtt - State->RttMean);
+	}
+}
+
+void UFGNetTelemetrySubsystem::AddArrival(const UNetConnection* Connection, float SendTime, float ArrivalTime)
+{
+	FConnectionState* State = FindState(Connection);
+
+	if (State == nullptr)
+	{
+		return;
+	}
+
+	//RFC 3550, the clocks do not need to agree because only the change in transit time is used.
+	const float Transit = ArrivalTime - SendTime;
+
+	if (State->bHasTransit)
+	{
+		State->Jitter += (FMath::Abs(Transit - State->LastTransit) - State->Jitter) / 16.0f;
+	}
+
+	State->LastTransit = Transit;
+	State->bHasTransit = true;
+}
+
+void UFGNetTelemetrySubsystem::AddOutOfOrder(const UNetConnection* Connection)
+{
+	if (FConnectionState* State = FindState(Connection))
+	{
+		State->OutOfOrder++;
+	}
+}
+
+void UFGNetTelemetrySubsystem::AddSnapCorrection(const UNetConnection* Connection)
+{
+	if (FConnectionState* State = FindState(Connection))
+	{
+		State->SnapCorrections++;
+	}
+}
+
+void UFGNetTelemetrySubsystem::AddPredictionCorrection(const UNetConnection* Connection)
+{
+	if (FConnectionState* State = FindState(Connection))
+	{
+		State->PredictionCorrections++;
+	}
+}
+
+void UFGNetTelemetrySubsystem::GetLatest(TArray<FFGConnectionTelemetry>& OutTelemetry) const
+{
+	for (const TPair<const UNetConnection*, FConnectionState>& Pair : Connections)
+	{
+		if (Pair.Value.History.Num() > 0)
+		{
+			OutTelemetry.Add(Pair.Value.History.Last());
+		}
+	}
+}
+
+UFGNetTelemetrySubsystem::FConnectionState* UFGNetTelemetrySubsystem::FindState(const UNetConnection* Connection)
+{
+	if (Connection == nullptr)
+	{
+		const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+		Connection = NetDriver != nullptr ? NetDriver->ServerConnection : nullptr;
+	}
+
+	return Connection != nullptr ? &Connections.FindOrAdd(Connection) : nullptr;
+}
+
+void UFGNetTelemetrySubsystem::TakeSamples(float Elapsed)
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	TArray<const UNetConnection*, TInlineAllocator<16>> LiveConnections;
+
+	if (NetDriver->ServerConnection != nullptr)
+	{
+		LiveConnections.Add(NetDriver->ServerConnection);
+	}
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection != nullptr)
+		{
+			LiveConnections.Add(Connection);
+		}
+	}
+
+	for (auto It = Connections.CreateIterator(); It; ++It)
+	{
+		if (!LiveConnections.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const float InvElapsed = 1.0f / FMath::Max(Elapsed, KINDA_SMALL_NUMBER);
+	const int32 MaxHistory = FMath::Max(HistoryLength, 1);
+	const bool bWriteLog = bWriteLogOnDedicatedServer && IsRunningDedicatedServer();
+
+	for (const UNetConnection* Connection : LiveConnections)
+	{
+		FConnectionState& State = Connections.FindOrAdd(Connection);
+
+		if (State.Address.IsEmpty())
+		{
+			State.Address = Connection->LowLevelGetRemoteAddress(true);
+			State.LastInPackets = Connection->InTotalPackets;
+			State.LastOutPackets = Connection->OutTotalPackets;
+			State.LastInPacketsLost = Connection->InTotalPacketsLost;
+			State.LastOutPacketsLost = Connection->OutTotalPacketsLost;
+		}
+
+		//Clients time their move acks, the server times the acks of the movement updates it sends. A connection that got
+		//no updates in the interval, e.g. the only player on the server, falls back to the engine's smoothed ping. That
+		//is one already averaged value, so there is no spread to report for it.
+		if (State.NumRttSamples == 0 && Connection->PlayerController != nullptr && Connection->PlayerController->PlayerState != nullptr)
+		{
+			State.NumRttSamples = 1;
+			State.RttMean = Connection->PlayerController->PlayerState->ExactPing * 0.001f;
+			State.RttM2 = 0.0;
+		}
+
+		const int32 InPackets = Connection->InTotalPackets - State.LastInPackets;
+		const int32 OutPackets = Connection->OutTotalPackets - State.LastOutPackets;
+		const int32 InPacketsLost = Connection->InTotalPacketsLost - State.LastInPacketsLost;
+		const int32 OutPacketsLost = Connection->OutTotalPacketsLost - State.LastOutPacketsLost;
+
+		FFGConnectionTelemetry Telemetry;
+		Telemetry.Address = State.Address;
+		Telemetry.Time = GetWorld()->GetTimeSeconds();
+		Telemetry.RttMean = State.RttMean * 1000.0f;
+		Telemetry.RttStdDev = !State.bIsRttMeasured ? -1.0f : State.NumRttSamples > 1 ? FMath::Sqrt(State.RttM2 / (State.NumRttSamples - 1)) * 1000.0f : 0.0f;
+		Telemetry.Jitter = State.Jitter * 1000.0f;
+		Telemetry.InLoss = InPackets + InPacketsLost > 0 ? 100.0f * InPacketsLost / (InPackets + InPacketsLost) : 0.0f;
+		Telemetry.OutLoss = OutPackets > 0 ? 100.0f * OutPacketsLost / OutPackets : 0.0f;
+		Telemetry.OutOfOrder = State.OutOfOrder;
+		Telemetry.SnapCorrectionsPerSecond = State.SnapCorrections * InvElapsed;
+		Telemetry.PredictionCorrectionsPerSecond = State.PredictionCorrections * InvElapsed;
+
+		if (State.History.Num() >= MaxHistory)
+		{
+			State.History.RemoveAt(0, State.History.Num() - MaxHistory + 1, false);
+		}
+
+		State.History.Add(Telemetry);
+
+		if (bWriteLog)
+		{
+			WriteLog(Telemetry);
+		}
+
+		//The jitter estimate carries over, everything else is per interval.
+		State.NumRttSamples = 0;
+		State.RttMean = 0.0;
+		State.RttM2 = 0.0;
+		State.bIsRttMeasured = false;
+		State.OutOfOrder = 0;
+		State.SnapCorrections = 0;
+		State.PredictionCorrections = 0;
+		State.LastInPackets = Connection->InTotalPackets;
+		State.LastOutPackets = Connection->OutTotalPackets;
+		State.LastInPacketsLost = Connection->InTotalPacketsLost;
+		State.LastOutPacketsLost = Connection->OutTotalPacketsLost;
+	}
+
+	SampleVersion++;
+}
+
+void UFGNetTelemetrySubsystem::WriteLog(const FFGConnectionTelemetry& Telemetry)
+{
+	const FString FileName = FPaths::Combine(FPaths::ProjectLogDir(), TEXT("FGNetTelemetry.csv"));
+
+	if (LogWriter != nullptr && LogWriter->TotalSize() > MaxLogFileSize)
+	{
+		LogWriter->Close();
+		delete LogWriter;
+		LogWriter = nullptr;
+
+		IFileManager::Get().Move(*FPaths::Combine(FPaths::ProjectLogDir(), TEXT("FGNetTelemetry-Previous.csv")), *FileName, true);
+	}
+
+	if (LogWriter == nullptr)
+	{
+		const bool bNewFile = IFileManager::Get().FileSize(*FileName) <= 0;
+		LogWriter = IFileManager::Get().CreateFileWriter(*FileName, FILEWRITE_Append | FILEWRITE_AllowRead);
+
+		if (LogWriter == nullptr)
+		{
+			return;
+		}
+
+		if (bNewFile)
+		{
+			const FTCHARToUTF8 Header(TelemetryLogHeader);
+			LogWriter->Serialize(const_cast<ANSICHAR*>(Header.Get()), Header.Length());
+		}
+	}
+
+	const FString Line = FString::Printf(TEXT("%.2f,%s,%.1f,%.1f,%.1f,%.2f,%.2f,%d,%.2f,%.2f\n"), Telemetry.Time, *Telemetry.Address, Telemetry.RttMean, Telemetry.RttStdDev, Telemetry.Jitter, Telemetry.InLoss, Telemetry.OutLoss, Telemetry.OutOfOrder, Telemetry.SnapCorrectionsPerSecond, Telemetry.PredictionCorrectionsPerSecond);
+	const FTCHARToUTF8 Utf8Line(*Line);
+	LogWriter->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+	LogWriter->Flush();
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGNetTelemetrySubsystem.generated.h"
+
+class UNetConnection;
+class FArchive;
+
+//Quality of one connection over one sample interval.
+USTRUCT(BlueprintType)
+struct FFGConnectionTelemetry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	FString Address;
+
+	//World time at the end of the interval.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float Time = 0.0f;
+
+	//Milliseconds.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float RttMean = 0.0f;
+
+	//Milliseconds, -1 where only the engine's smoothed ping is known because nothing was timed in the interval.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float RttStdDev = 0.0f;
+
+	//RFC 3550 interarrival jitter of movement packets, milliseconds.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float Jitter = 0.0f;
+
+	//Percent of packets lost in the interval.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float InLoss = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float OutLoss = 0.0f;
+
+	//Movement packets and acks that arrived after a newer one.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	int32 OutOfOrder = 0;
+
+	//Remote players snapped to a received location further away than the correction threshold.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float SnapCorrectionsPerSecond = 0.0f;
+
+	//Our own predicted movement corrected by the server.
+	UPROPERTY(BlueprintReadOnly, Category = Telemetry)
+	float PredictionCorrectionsPerSecond = 0.0f;
+};
+
+//Measures every connection of this world at a fixed rate: round trip time, jitter, loss, reordering and how often
+//movement had to be corrected. Feeds UFGNetDebugWidget and writes a rolling CSV log on dedicated servers.
+UCLASS(Config = Game)
+class FGNET_API UFGNetTelemetrySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	//A null connection on a client means the one to the server. Times are in seconds.
+	void AddRttSample(const UNetConnection* Connection, float Rtt);
+
+	//SendTime is the sender's clock, only differences between packets are used.
+	void AddArrival(const UNetConnection* Connection, float SendTime, float ArrivalTime);
+
+	void AddOutOfOrder(const UNetConnection* Connection);
+
+	void AddSnapCorrection(const UNetConnection* Connection);
+
+	void AddPredictionCorrection(const UNetConnection* Connection);
+
+	//The newest sample of every connection.
+	void GetLatest(TArray<FFGConnectionTelemetry>& OutTelemetry) const;
+
+	//Changes every time a sample is taken.
+	int32 GetSampleVersion() const { return SampleVersion; }
+
+	UPROPERTY(Config)
+	float SampleInterval = 1.0f;
+
+	//Samples kept per connection.
+	UPROPERTY(Config)
+	int32 HistoryLength = 60;
+
+	UPROPERTY(Config)
+	bool bWriteLogOnDedicatedServer = true;
+
+	//The log starts over in a new file past this, the previous one is kept as FGNetTelemetry-Previous.csv.
+	UPROPERTY(Config)
+	int32 MaxLogFileSize = 4 * 1024 * 1024;
+
+private:
+
+	struct FConnectionState
+	{
+		FString Address;
+
+		//Welford's running mean and sum of squared differences.
+		//Samples are our own timings when bIsRttMeasured, otherwise the one engine ping read at the end of the interval.
+		int32 NumRttSamples = 0;
+		double RttMean = 0.0;
+		double RttM2 = 0.0;
+		bool bIsRttMeasured = false;
+
+		float Jitter = 0.0f;
+		float LastTransit = 0.0f;
+		bool bHasTransit = false;
+
+		int32 OutOfOrder = 0;
+		int32 SnapCorrections = 0;
+		int32 PredictionCorrections = 0;
+
+		int32 LastInPackets = 0;
+		int32 LastOutPackets = 0;
+		int32 LastInPacketsLost = 0;
+		int32 LastOutPacketsLost = 0;
+
+		TArray<FFGConnectionTelemetry> History;
+	};
+
+	FConnectionState* FindState(const UNetConnection* Connection);
+
+	void TakeSamples(float Elapsed);
+
+	void WriteLog(const FFGConnectionTelemetry& Telemetry);
+
+	TMap<const UNetConnection*, FConnectionState> Connections;
+
+	float TimeSinceSample = 0.0f;
+
+	int32 SampleVersion = 0;
+
+	FArchive* LogWriter = nullptr;
+};
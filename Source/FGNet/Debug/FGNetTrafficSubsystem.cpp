@@ -0,0 +1,314 @@
+#include "FGNetTrafficSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/CoreNet.h"
+#include "UObject/UnrealType.h"
+#include "../FGNet.h"
+
+static FAutoConsoleCommandWithWorld ExportTrafficCsvCommand(
+	TEXT("FGNet.ExportTrafficCsv"),
+	TEXT("Writes the RPC and property traffic of this world to Saved/Profiling/FGNet."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFGNetTrafficSubsystem* TrafficSubsystem = World != nullptr ? World->GetSubsystem<UFGNetTrafficSubsystem>() : nullptr)
+		{
+			TrafficSubsystem->ExportCsv();
+		}
+	}));
+
+static const TCHAR* LexToString(EFGNetTrafficKind Kind)
+{
+	switch (Kind)
+	{
+		case EFGNetTrafficKind::RpcOut:
+			return TEXT("RpcOut");
+
+		case EFGNetTrafficKind::RpcIn:
+			return TEXT("RpcIn");
+
+		case EFGNetTrafficKind::PropertyIn:
+			return TEXT("PropertyIn");
+
+		default:
+			return TEXT("Property");
+	}
+}
+
+void UFGNetTrafficSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	//The world dispatches received packets between the start of its tick and the actor tick, anything our code calls
+	//runs from the actor tick on.
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UFGNetTrafficSubsystem::OnWorldTickStart);
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UFGNetTrafficSubsystem::OnWorldPreActorTick);
+}
+
+void UFGNetTrafficSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	Entries.Reset();
+	EntryIndices.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGNetTrafficSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+
+	if (TimeSinceUpdate >= 1.0f)
+	{
+		UpdateRates(TimeSinceUpdate);
+		TimeSinceUpdate = 0.0f;
+	}
+
+	if (CsvExportInterval > 0.0f)
+	{
+		TimeSinceExport += DeltaTime;
+
+		if (TimeSinceExport >= CsvExportInterval)
+		{
+			TimeSinceExport = 0.0f;
+			ExportCsv();
+		}
+	}
+}
+
+bool UFGNetTrafficSubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World != nullptr && World->GetNetDriver() != nullptr && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGNetTrafficSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGNetTrafficSubsystem::RecordRpc(const UFunction* Function, void* Parameters, bool bIncoming)
+{
+	int32 Bits = 0;
+
+	for (TFieldIterator<FProperty> It(Function); It && (It->PropertyFlags & (CPF_Parm | CPF_ReturnParm)) == CPF_Parm; ++It)
+	{
+		Bits += MeasureBits(*It, It->ContainerPtrToValuePtr<void>(Parameters));
+	}
+
+	Record(Function->GetFName(), bIncoming ? EFGNetTrafficKind::RpcIn : EFGNetTrafficKind::RpcOut, Bits);
+}
+
+void UFGNetTrafficSubsystem::RecordSentRpc(const UObject* Object, const UFunction* Function, void* Parameters)
+{
+	const UWorld* World = Object->GetWorld();
+
+	if (UFGNetTrafficSubsystem* TrafficSubsystem = World != nullptr ? World->GetSubsystem<UFGNetTrafficSubsystem>() : nullptr)
+	{
+		TrafficSubsystem->RecordRpc(Function, Parameters, false);
+	}
+}
+
+void UFGNetTrafficSubsystem::RecordProcessedRpc(const UObject* Object, const UFunction* Function, void* Parameters)
+{
+	//Local calls of an RPC run here as well, the ones we sent were counted in CallRemoteFunction.
+	if (!Function->HasAnyFunctionFlags(FUNC_Net))
+	{
+		return;
+	}
+
+	const UWorld* World = Object->GetWorld();
+	UFGNetTrafficSubsystem* TrafficSubsystem = World != nullptr ? World->GetSubsystem<UFGNetTrafficSubsystem>() : nullptr;
+
+	if (TrafficSubsystem != nullptr && TrafficSubsystem->IsReceivingPackets())
+	{
+		TrafficSubsystem->RecordRpc(Function, Parameters, true);
+	}
+}
+
+void UFGNetTrafficSubsystem::RecordProperty(const FProperty* Property, const void* Container, bool bIncoming)
+{
+	Record(Property->GetFName(), bIncoming ? EFGNetTrafficKind::PropertyIn : EFGNetTrafficKind::Property, MeasureBits(Property, Property->ContainerPtrToValuePtr<void>(Container)));
+}
+
+void UFGNetTrafficSubsystem::Record(FName Name, EFGNetTrafficKind Kind, int32 Bits)
+{
+	const TPair<FName, uint8> Key(Name, static_cast<uint8>(Kind));
+	int32* Index = EntryIndices.Find(Key);
+
+	if (Index == nullptr)
+	{
+		FFGNetTrafficEntry& NewEntry = Entries.AddDefaulted_GetRef();
+		NewEntry.Name = Name;
+		NewEntry.Kind = Kind;
+		Index = &EntryIndices.Add(Key, Entries.Num() - 1);
+	}
+
+	FFGNetTrafficEntry& Entry = Entries[*Index];
+	Entry.Calls++;
+	Entry.Bits += Bits;
+}
+
+void UFGNetTrafficSubsystem::GetConnections(TArray<FFGNetConnectionTraffic>& OutConnections) const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	if (NetDriver == nullptr)
+	{
+		return;
+	}
+
+	auto AddConnection = [&OutConnections](const UNetConnection* Connection)
+	{
+		FFGNetConnectionTraffic& Traffic = OutConnections.AddDefaulted_GetRef();
+		Traffic.Address = Connection->LowLevelGetRemoteAddress(true);
+		Traffic.InBytesPerSecond = Connection->InBytesPerSecond;
+		Traffic.OutBytesPerSecond = Connection->OutBytesPerSecond;
+		Traffic.InTotalBytes = Connection->InTotalBytes;
+		Traffic.OutTotalBytes = Connection->OutTotalBytes;
+	};
+
+	if (NetDriver->ServerConnection != nullptr)
+	{
+		AddConnection(NetDriver->ServerConnection);
+	}
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection != nullptr)
+		{
+			AddConnection(Connection);
+		}
+	}
+}
+
+FString UFGNetTrafficSubsystem::ExportCsv() const
+{
+	FString Csv = TEXT("Name,Kind,CallsPerSecond,BitsPerCall,BytesPerSecond,TotalCalls,TotalBytes\n");
+
+	for (const FFGNetTrafficEntry& Entry : Entries)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%.2f,%.1f,%d,%lld,%lld\n"), *Entry.Name.ToString(), LexToString(Entry.Kind), Entry.CallsPerSecond, Entry.BitsPerCall, Entry.BytesPerSecond, Entry.TotalCalls, Entry.TotalBytes);
+	}
+
+	TArray<FFGNetConnectionTraffic> Connections;
+	GetConnections(Connections);
+
+	for (const FFGNetConnectionTraffic& Connection : Connections)
+	{
+		Csv += FString::Printf(TEXT("%s,ConnectionIn,,,%d,,%d\n"), *Connection.Address, Connection.InBytesPerSecond, Connection.InTotalBytes);
+		Csv += FString::Printf(TEXT("%s,ConnectionOut,,,%d,,%d\n"), *Connection.Address, Connection.OutBytesPerSecond, Connection.OutTotalBytes);
+	}
+
+	const FString FileName = FPaths::Combine(FPaths::ProfilingDir(), TEXT("FGNet"), FString::Printf(TEXT("Traffic-%s.csv"), *FDateTime::Now().ToString()));
+
+	if (!FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		UE_LOG(LogFGNet, Warning, TEXT("Could not write traffic to %s"), *FileName);
+		return FString();
+	}
+
+	UE_LOG(LogFGNet, Display, TEXT("Wrote traffic to %s"), *FileName);
+	return FileName;
+}
+
+int32 UFGNetTrafficSubsystem::MeasureBits(const FProperty* Property, const void* Value)
+{
+	if (Property->IsA<FObjectPropertyBase>())
+	{
+		return FGNET_TRAFFIC_OBJECT_REFERENCE_BITS * Property->ArrayDim;
+	}
+
+	if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		//Arrays are sent as a count followed by their elements.
+		FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+		int32 Bits = 16;
+
+		for (int32 Index = 0; Index < ArrayHelper.Num(); Index++)
+		{
+			Bits += MeasureBits(ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index));
+		}
+
+		return Bits;
+	}
+
+	const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+
+	if (StructProperty != nullptr && !(StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative))
+	{
+		return MeasureStructBits(StructProperty->Struct, Value);
+	}
+
+	//None of our NetSerialize implementations use the package map.
+	FNetBitWriter Writer(nullptr, 256);
+	Writer.SetAllowResize(true);
+	Property->NetSerializeItem(Writer, nullptr, const_cast<void*>(Value));
+	return static_cast<int32>(Writer.GetNumBits());
+}
+
+int32 UFGNetTrafficSubsystem::MeasureStructBits(const UScriptStruct* Struct, const void* Value)
+{
+	//Structs without their own NetSerialize are sent field by field.
+	int32 Bits = 0;
+
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		if (!(It->PropertyFlags & CPF_RepSkip))
+		{
+			Bits += MeasureBits(*It, It->ContainerPtrToValuePtr<void>(Value));
+		}
+	}
+
+	return Bits;
+}
+
+void UFGNetTrafficSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (InWorld == GetWorld())
+	{
+		bIsReceivingPackets = true;
+	}
+}
+
+void UFGNetTrafficSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (InWorld == GetWorld())
+	{
+		bIsReceivingPackets = false;
+	}
+}
+
+void UFGNetTrafficSubsystem::UpdateRates(float Elapsed)
+{
+	const float InvElapsed = 1.0f / FMath::Max(Elapsed, KINDA_SMALL_NUMBER);
+	const int32 MaxHistory = FMath::Max(HistoryLength, 1);
+
+	for (FFGNetTrafficEntry& Entry : Entries)
+	{
+		Entry.TotalCalls += Entry.Calls;
+		Entry.TotalBits += Entry.Bits;
+		Entry.TotalBytes = Entry.TotalBits / 8;
+
+		Entry.CallsPerSecond = Entry.Calls * InvElapsed;
+		Entry.BitsPerCall = Entry.Calls > 0 ? static_cast<float>(Entry.Bits) / Entry.Calls : 0.0f;
+		Entry.BytesPerSecond = FMath::RoundToInt(Entry.Bits * InvElapsed / 8.0f);
+
+		if (Entry.History.Num() >= MaxHistory)
+		{
+			Entry.History.RemoveAt(0, Entry.History.Num() - MaxHistory + 1, false);
+		}
+
+		Entry.History.Add(Entry.BytesPerSecond);
+
+		Entry.Calls = 0;
+		Entry.Bits = 0;
+	}
+
+	ReportVersion++;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGNetTrafficSubsystem.generated.h"
+
+//Traffic accounting costs a parameter serialization per RPC and per property update, it is compiled out of shipping builds.
+#ifndef FGNET_TRAFFIC_STATS
+#define FGNET_TRAFFIC_STATS !UE_BUILD_SHIPPING
+#endif
+
+//Bits counted for an object reference, the real size depends on whether its NetGUID was exported before.
+#ifndef FGNET_TRAFFIC_OBJECT_REFERENCE_BITS
+#define FGNET_TRAFFIC_OBJECT_REFERENCE_BITS 32
+#endif
+
+UENUM(BlueprintType)
+enum class EFGNetTrafficKind : uint8
+{
+	RpcOut,
+	RpcIn,
+	//Sent by the server.
+	Property,
+	//Received on a client.
+	PropertyIn,
+};
+
+//One RPC or replicated property, rates are over the last second.
+USTRUCT(BlueprintType)
+struct FFGNetTrafficEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	FName Name;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	EFGNetTrafficKind Kind = EFGNetTrafficKind::RpcOut;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	float CallsPerSecond = 0.0f;
+
+	//Payload only, bunch and RPC headers are not included.
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	float BitsPerCall = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int32 BytesPerSecond = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int64 TotalCalls = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int64 TotalBytes = 0;
+
+	//Bytes per second for the last HistoryLength seconds, oldest first.
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	TArray<int32> History;
+
+	int32 Calls = 0;
+
+	int64 Bits = 0;
+
+	int64 TotalBits = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FFGNetConnectionTraffic
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	FString Address;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int32 InBytesPerSecond = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int32 OutBytesPerSecond = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int32 InTotalBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Traffic)
+	int32 OutTotalBytes = 0;
+};
+
+//Counts calls and payload bits of every FGNet RPC and replicated property this machine sends or receives, and rolls
+//them into per second rates with a short history. Shown by UFGNetDebugWidget, FGNet.ExportTrafficCsv writes it to disk.
+UCLASS(Config = Game)
+class FGNET_API UFGNetTrafficSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	//Parameters is the RPC's parameter struct as passed to ProcessEvent.
+	void RecordRpc(const UFunction* Function, void* Parameters, bool bIncoming);
+
+	//For CallRemoteFunction overrides, counts an RPC Object sends.
+	static void RecordSentRpc(const UObject* Object, const UFunction* Function, void* Parameters);
+
+	//For ProcessEvent overrides, counts the RPC if it came in over the network and is not a local call.
+	static void RecordProcessedRpc(const UObject* Object, const UFunction* Function, void* Parameters);
+
+	//True while the world hands out the packets received since the last frame, which is when incoming RPCs run.
+	bool IsReceivingPackets() const { return bIsReceivingPackets; }
+
+	//Container is the object or struct the property lives in.
+	void RecordProperty(const FProperty* Property, const void* Container, bool bIncoming);
+
+	void Record(FName Name, EFGNetTrafficKind Kind, int32 Bits);
+
+	const TArray<FFGNetTrafficEntry>& GetEntries() const { return Entries; }
+
+	void GetConnections(TArray<FFGNetConnectionTraffic>& OutConnections) const;
+
+	//Changes every time the rates are updated.
+	int32 GetReportVersion() const { return ReportVersion; }
+
+	//Writes the current rates and totals to Saved/Profiling/FGNet, returns the file name or an empty string.
+	FString ExportCsv() const;
+
+	//Payload bits of a value, serialized the way it is sent.
+	static int32 MeasureBits(const FProperty* Property, const void* Value);
+
+	static int32 MeasureStructBits(const UScriptStruct* Struct, const void* Value);
+
+	//Seconds of history kept per entry.
+	UPROPERTY(Config)
+	int32 HistoryLength = 30;
+
+	//Write a CSV every this many seconds, for headless servers. 0 turns it off.
+	UPROPERTY(Config)
+	float CsvExportInterval = 0.0f;
+
+private:
+
+	void UpdateRates(float Elapsed);
+
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+
+	TArray<FFGNetTrafficEntry> Entries;
+
+	TMap<TPair<FName, uint8>, int32> EntryIndices;
+
+	float TimeSinceUpdate = 0.0f;
+
+	float TimeSinceExport = 0.0f;
+
+	int32 ReportVersion = 0;
+
+	bool bIsReceivingPackets = false;
+
+	FDelegateHandle WorldTickStartHandle;
+
+	FDelegateHandle WorldPreActorTickHandle;
+};
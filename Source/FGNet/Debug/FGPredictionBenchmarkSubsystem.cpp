@@ -0,0 +1,366 @@
+#include "FGPredictionBenchmarkSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "../FGNet.h"
+#include "../FGRocketSubsystem.h"
+#include "../Player/FGPlayer.h"
+#include "FGLoadTestSubsystem.h"
+
+//Absolute slack per metric, so a baseline close to zero does not fail on noise.
+const static float ProxyErrorSlack = 5.0f;
+const static float CorrectionRateSlack = 0.5f;
+const static float CorrectionMagnitudeSlack = 5.0f;
+const static float HitDisagreementSlack = 0.1f;
+
+void UFGPredictionBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Profiles.RemoveAll([](const FFGNetBenchmarkProfile& Profile) { return !ShouldRunProfile(Profile); });
+	bIsEnabled = !IsRunningDedicatedServer() && FParse::Param(FCommandLine::Get(), TEXT("FGNetPredictionBenchmark")) && Profiles.Num() > 0;
+
+	//With several bots only the first one writes the baseline.
+	FParse::Value(FCommandLine::Get(), TEXT("FGNetBotSeed="), BotSeed);
+	bUpdateBaseline = BotSeed == 0 && FParse::Param(FCommandLine::Get(), TEXT("FGNetPredictionBaselineUpdate"));
+}
+
+void UFGPredictionBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetTickableGameObjectWorld();
+	const UFGRocketSubsystem* RocketSubsystem = World->GetSubsystem<UFGRocketSubsystem>();
+
+	if (!bHasStartTime || World->GetNetDriver() == nullptr || RocketSubsystem == nullptr)
+	{
+		return;
+	}
+
+	//Also after a respawn, the hit test needs to know which rockets are ours.
+	if (!Player.IsValid())
+	{
+		APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController(World);
+		Player = PlayerController != nullptr ? PlayerController->GetPawn<AFGPlayer>() : nullptr;
+	}
+
+	//Scheduled on the server's clock instead of our own, so every bot runs the same profile at the same time.
+	const float ProfileLength = WarmupTime + ProfileDuration;
+	const float Elapsed = RocketSubsystem->GetServerWorldTime() - StartTime;
+
+	if (Elapsed < 0.0f)
+	{
+		return;
+	}
+
+	const int32 ScheduledIndex = FMath::FloorToInt(Elapsed / ProfileLength);
+
+	if (ScheduledIndex != ProfileIndex)
+	{
+		if (ProfileIndex != INDEX_NONE)
+		{
+			FinishProfile();
+		}
+
+		if (ScheduledIndex >= Profiles.Num())
+		{
+			Finish();
+			return;
+		}
+
+		StartProfile(ScheduledIndex);
+	}
+
+	ProfileTime = Elapsed - ScheduledIndex * ProfileLength;
+	bIsRecording = ProfileTime >= WarmupTime;
+}
+
+bool UFGPredictionBenchmarkSubsystem::IsTickable() const
+{
+	return bIsEnabled && GetTickableGameObjectWorld() != nullptr && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGPredictionBenchmarkSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+UWorld* UFGPredictionBenchmarkSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetGameInstance()->GetWorld();
+}
+
+void UFGPredictionBenchmarkSubsystem::AddProxyError(float Error)
+{
+	if (bIsRecording)
+	{
+		NumProxyErrors++;
+		ProxyErrorSum += Error;
+	}
+}
+
+void UFGPredictionBenchmarkSubsystem::AddPredictionCorrection(float Magnitude)
+{
+	if (bIsRecording)
+	{
+		NumCorrections++;
+		CorrectionSum += Magnitude;
+	}
+}
+
+void UFGPredictionBenchmarkSubsystem::TestViewHit(const AFGPlayer* Shooter, uint8 RocketId, const FVector& StartLocation, const FVector& EndLocation)
+{
+	if (!bIsRecording || Shooter != Player.Get() || ViewHitRockets.Contains(RocketId))
+	{
+		return;
+	}
+
+	for (TActorIterator<AFGPlayer> It(GetTickableGameObjectWorld()); It; ++It)
+	{
+		if (*It == Shooter)
+		{
+			continue;
+		}
+
+		const FVector PlayerLocation = It->GetActorLocation();
+		const FVector ClosestPoint = FMath::ClosestPointOnSegment(PlayerLocation, StartLocation, EndLocation);
+
+		if (FVector::DistSquared(ClosestPoint, PlayerLocation) <= FMath::Square(It->GetCollisionRadius()))
+		{
+			ViewHitRockets.Add(RocketId);
+			return;
+		}
+	}
+}
+
+void UFGPredictionBenchmarkSubsystem::AddServerHit(uint8 RocketId)
+{
+	if (bIsRecording)
+	{
+		ServerHitRockets.Add(RocketId);
+	}
+}
+
+void UFGPredictionBenchmarkSubsystem::SetStartTime(float InStartTime)
+{
+	StartTime = InStartTime;
+	bHasStartTime = true;
+}
+
+float UFGPredictionBenchmarkSubsystem::GetTotalDuration() const
+{
+	const int32 NumProfiles = Profiles.FilterByPredicate([](const FFGNetBenchmarkProfile& Profile) { return ShouldRunProfile(Profile); }).Num();
+	return NumProfiles * (WarmupTime + ProfileDuration);
+}
+
+bool UFGPredictionBenchmarkSubsystem::ShouldRunProfile(const FFGNetBenchmarkProfile& Profile)
+{
+	FString OnlyProfile;
+	return !FParse::Value(FCommandLine::Get(), TEXT("FGNetPredictionProfile="), OnlyProfile) || OnlyProfile == Profile.Name;
+}
+
+void UFGPredictionBenchmarkSubsystem::StartProfile(int32 Index)
+{
+	ProfileIndex = Index;
+	ProfileTime = 0.0f;
+	bIsRecording = false;
+	NumProxyErrors = 0;
+	ProxyErrorSum = 0.0;
+	NumCorrections = 0;
+	CorrectionSum = 0.0;
+	ViewHitRockets.Reset();
+	ServerHitRockets.Reset();
+
+	ApplyNetworkSimulation(Profiles[Index]);
+
+	//The other bot restarts its input at the same time, so both drive the same way in every run of a profile.
+	if (UFGLoadTestSubsystem* LoadTestSubsystem = GetGameInstance()->GetSubsystem<UFGLoadTestSubsystem>())
+	{
+		LoadTestSubsystem->RestartBot(Index);
+	}
+
+	UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark profile %s"), *Profiles[Index].Name);
+}
+
+void UFGPredictionBenchmarkSubsystem::FinishProfile()
+{
+	FFGNetBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Name = Profiles[ProfileIndex].Name;
+	Result.ProxyError = NumProxyErrors > 0 ? ProxyErrorSum / NumProxyErrors : 0.0f;
+	Result.CorrectionsPerSecond = NumCorrections / ProfileDuration;
+	Result.CorrectionMagnitude = NumCorrections > 0 ? CorrectionSum / NumCorrections : 0.0f;
+
+	//A phantom hit and a missed one are two disagreements, not none.
+	const int32 NumDisagreements = ViewHitRockets.Difference(ServerHitRockets).Num() + ServerHitRockets.Difference(ViewHitRockets).Num();
+	const int32 NumHitRockets = ViewHitRockets.Union(ServerHitRockets).Num();
+	Result.HitDisagreement = NumHitRockets > 0 ? (float)NumDisagreements / NumHitRockets : 0.0f;
+
+	bIsRecording = false;
+}
+
+void UFGPredictionBenchmarkSubsystem::ApplyNetworkSimulation(const FFGNetBenchmarkProfile& Profile)
+{
+#if DO_ENABLE_NET_TEST
+	if (UNetDriver* NetDriver = GetTickableGameObjectWorld()->GetNetDriver())
+	{
+		FPacketSimulationSettings PacketSimulation;
+		PacketSimulation.PktLagMin = Profile.MinLatency;
+		PacketSimulation.PktLagMax = Profile.MaxLatency;
+		PacketSimulation.PktLoss = Profile.PacketLoss;
+		PacketSimulation.PktIncomingLagMin = Profile.MinLatency;
+		PacketSimulation.PktIncomingLagMax = Profile.MaxLatency;
+		PacketSimulation.PktIncomingLoss = Profile.PacketLoss;
+
+		NetDriver->SetPacketSimulationSettings(PacketSimulation);
+	}
+#else
+	UE_LOG(LogFGNet, Warning, TEXT("Packet simulation is compiled out, profile %s runs without it"), *Profile.Name);
+#endif // DO_ENABLE_NET_TEST
+}
+
+void UFGPredictionBenchmarkSubsystem::Finish()
+{
+	bIsEnabled = false;
+	ApplyNetworkSimulation(FFGNetBenchmarkProfile());
+
+	const FString Csv = ResultsToCsv(Results);
+	const FString ResultsFile = FPaths::Combine(FPaths::ProfilingDir(), TEXT("FGNet"), FString::Printf(TEXT("PredictionBenchmark-Bot%d-%s.csv"), BotSeed, *FDateTime::Now().ToString()));
+	FFileHelper::SaveStringToFile(Csv, *ResultsFile);
+	UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark results written to %s"), *ResultsFile);
+
+	bool bPassed = true;
+
+	if (bUpdateBaseline)
+	{
+		UpdateBaseline();
+	}
+
+	else
+	{
+		bPassed = CompareWithBaseline();
+	}
+
+	FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+}
+
+bool UFGPredictionBenchmarkSubsystem::CompareWithBaseline() const
+{
+	const FString BaselinePath = GetBaselinePath();
+	TArray<FFGNetBenchmarkResult> Baseline;
+
+	if (!LoadResultsCsv(BaselinePath, Baseline))
+	{
+		UE_LOG(LogFGNet, Error, TEXT("No prediction benchmark baseline at %s, run with -FGNetPredictionBaselineUpdate to create one"), *BaselinePath);
+		return false;
+	}
+
+	bool bPassed = true;
+
+	auto CompareMetric = [this, &bPassed](const FString& Profile, const TCHAR* Metric, float Value, float BaselineValue, float Slack)
+	{
+		const float Limit = BaselineValue * (1.0f + RegressionTolerance) + Slack;
+
+		if (Value > Limit)
+		{
+			UE_LOG(LogFGNet, Error, TEXT("Prediction benchmark %s: %s regressed to %.3f, baseline %.3f, limit %.3f"), *Profile, Metric, Value, BaselineValue, Limit);
+			bPassed = false;
+		}
+
+		else
+		{
+			UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark %s: %s %.3f, baseline %.3f"), *Profile, Metric, Value, BaselineValue);
+		}
+	};
+
+	for (const FFGNetBenchmarkResult& Result : Results)
+	{
+		const FFGNetBenchmarkResult* BaselineResult = Baseline.FindByPredicate([&Result](const FFGNetBenchmarkResult& InResult) { return InResult.Name == Result.Name; });
+
+		if (BaselineResult == nullptr)
+		{
+			UE_LOG(LogFGNet, Error, TEXT("Prediction benchmark baseline has no profile %s, run with -FGNetPredictionBaselineUpdate to add it"), *Result.Name);
+			bPassed = false;
+			continue;
+		}
+
+		CompareMetric(Result.Name, TEXT("proxy error"), Result.ProxyError, BaselineResult->ProxyError, ProxyErrorSlack);
+		CompareMetric(Result.Name, TEXT("corrections per second"), Result.CorrectionsPerSecond, BaselineResult->CorrectionsPerSecond, CorrectionRateSlack);
+		CompareMetric(Result.Name, TEXT("correction magnitude"), Result.CorrectionMagnitude, BaselineResult->CorrectionMagnitude, CorrectionMagnitudeSlack);
+		CompareMetric(Result.Name, TEXT("hit disagreement"), Result.HitDisagreement, BaselineResult->HitDisagreement, HitDisagreementSlack);
+	}
+
+	return bPassed;
+}
+
+void UFGPredictionBenchmarkSubsystem::UpdateBaseline() const
+{
+	const FString BaselinePath = GetBaselinePath();
+	TArray<FFGNetBenchmarkResult> Baseline;
+	LoadResultsCsv(BaselinePath, Baseline);
+
+	for (const FFGNetBenchmarkResult& Result : Results)
+	{
+		if (FFGNetBenchmarkResult* BaselineResult = Baseline.FindByPredicate([&Result](const FFGNetBenchmarkResult& InResult) { return InResult.Name == Result.Name; }))
+		{
+			*BaselineResult = Result;
+		}
+
+		else
+		{
+			Baseline.Add(Result);
+		}
+	}
+
+	FFileHelper::SaveStringToFile(ResultsToCsv(Baseline), *BaselinePath);
+	UE_LOG(LogFGNet, Display, TEXT("Prediction benchmark baseline updated at %s"), *BaselinePath);
+}
+
+FString UFGPredictionBenchmarkSubsystem::GetBaselinePath() const
+{
+	return FPaths::Combine(FPaths::ProjectDir(), BaselineFile);
+}
+
+FString UFGPredictionBenchmarkSubsystem::ResultsToCsv(const TArray<FFGNetBenchmarkResult>& InResults)
+{
+	FString Csv = TEXT("Profile,ProxyError,CorrectionsPerSecond,CorrectionMagnitude,HitDisagreement\n");
+
+	for (const FFGNetBenchmarkResult& Result : InResults)
+	{
+		Csv += FString::Printf(TEXT("%s,%.3f,%.3f,%.3f,%.3f\n"), *Result.Name, Result.ProxyError, Result.CorrectionsPerSecond, Result.CorrectionMagnitude, Result.HitDisagreement);
+	}
+
+	return Csv;
+}
+
+bool UFGPredictionBenchmarkSubsystem::LoadResultsCsv(const FString& FileName, TArray<FFGNetBenchmarkResult>& OutResults)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FileName))
+	{
+		return false;
+	}
+
+	//First line is the header.
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		TArray<FString> Columns;
+
+		if (Lines[LineIndex].ParseIntoArray(Columns, TEXT(",")) < 5)
+		{
+			continue;
+		}
+
+		FFGNetBenchmarkResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = Columns[0];
+		Result.ProxyError = FCString::Atof(*Columns[1]);
+		Result.CorrectionsPerSecond = FCString::Atof(*Columns[2]);
+		Result.CorrectionMagnitude = FCString::Atof(*Columns[3]);
+		Result.HitDisagreement = FCString::Atof(*Columns[4]);
+	}
+
+	return true;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "FGPredictionBenchmarkSubsystem.generated.h"
+
+class AFGPlayer;
+
+//Network conditions the benchmark plays through, applied to both directions of the client's connection.
+USTRUCT()
+struct FFGNetBenchmarkProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FString Name;
+
+	//Milliseconds, the spread between the two is the jitter.
+	UPROPERTY(Config)
+	int32 MinLatency = 0;
+
+	UPROPERTY(Config)
+	int32 MaxLatency = 0;
+
+	//Percent.
+	UPROPERTY(Config)
+	int32 PacketLoss = 0;
+};
+
+//Prediction quality measured under one profile.
+struct FFGNetBenchmarkResult
+{
+	FString Name;
+
+	//Mean distance in cm between where a remote player was drawn and where it really was at the time it was drawn
+	//for. Snapshot interpolation draws remote players a playout delay in the past on purpose, that is not error.
+	float ProxyError = 0.0f;
+
+	float CorrectionsPerSecond = 0.0f;
+
+	//Mean distance in cm our own predicted location moved when the server corrected it.
+	float CorrectionMagnitude = 0.0f;
+
+	//Share of our rockets that hit a remote player as we drew them or on the server, but not both. Server hits are
+	//matched by rocket id without the shooter, so only meaningful in a two player session.
+	float HitDisagreement = 0.0f;
+};
+
+//Prediction quality benchmark. A client started with -FGNetPredictionBenchmark plays through the configured
+//latency, jitter and loss profiles, measures proxy error, corrections and hit disagreement under each, writes the
+//results to Saved/Profiling/FGNet and compares them to the baseline file. It quits with exit code 1 when any metric
+//got worse than the baseline by more than the tolerance, or when there is no baseline to compare with, so a change
+//that hurts smoothing or prediction fails the run.
+//A dedicated server started with -FGNetPredictionBenchmark runs the scripted two bot session, see UFGLoadTestSubsystem.
+//It tells the bots when to start, after that each profile starts at the same server world time on every bot.
+//-FGNetPredictionBaselineUpdate writes the results as the new baseline instead, -FGNetPredictionProfile=<Name> only
+//runs one profile. The FGNet.PredictionBenchmark automation test runs the whole thing, one profile per test.
+UCLASS(Config = Game)
+class FGNET_API UFGPredictionBenchmarkSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//FTickableGameObject
+
+	//Measurements only count while a profile is recording, outside of that these do nothing.
+	bool IsRecording() const { return bIsRecording; }
+
+	void AddProxyError(float Error);
+
+	void AddPredictionCorrection(float Magnitude);
+
+	//Counts a hit once per rocket if the rocket's path crosses a remote player where we draw them.
+	void TestViewHit(const AFGPlayer* Shooter, uint8 RocketId, const FVector& StartLocation, const FVector& EndLocation);
+
+	void AddServerHit(uint8 RocketId);
+
+	//Server world time the first profile starts at, sent by the benchmark server.
+	void SetStartTime(float InStartTime);
+
+	//How long a run through the profiles takes, once the bots have been told to start.
+	float GetTotalDuration() const;
+
+	//False for profiles -FGNetPredictionProfile leaves out.
+	static bool ShouldRunProfile(const FFGNetBenchmarkProfile& Profile);
+
+	UPROPERTY(Config)
+	TArray<FFGNetBenchmarkProfile> Profiles;
+
+	//Time after switching profile before measuring, so the previous profile's packets are out of the way.
+	UPROPERTY(Config)
+	float WarmupTime = 3.0f;
+
+	UPROPERTY(Config)
+	float ProfileDuration = 30.0f;
+
+	//How much worse than the baseline a metric may get, on top of a small absolute slack for noise.
+	UPROPERTY(Config)
+	float RegressionTolerance = 0.25f;
+
+	//Relative to the project directory.
+	UPROPERTY(Config)
+	FString BaselineFile = TEXT("Build/FGNetPredictionBaseline.csv");
+
+private:
+
+	void StartProfile(int32 Index);
+
+	void FinishProfile();
+
+	void ApplyNetworkSimulation(const FFGNetBenchmarkProfile& Profile);
+
+	void Finish();
+
+	//Returns false when a metric regressed or has no baseline.
+	bool CompareWithBaseline() const;
+
+	//Replaces the baseline of the profiles that ran, the others are kept.
+	void UpdateBaseline() const;
+
+	FString GetBaselinePath() const;
+
+	static FString ResultsToCsv(const TArray<FFGNetBenchmarkResult>& InResults);
+
+	static bool LoadResultsCsv(const FString& FileName, TArray<FFGNetBenchmarkResult>& OutResults);
+
+	bool bIsEnabled = false;
+
+	bool bUpdateBaseline = false;
+
+	int32 BotSeed = 0;
+
+	bool bHasStartTime = false;
+
+	float StartTime = 0.0f;
+
+	bool bIsRecording = false;
+
+	int32 ProfileIndex = INDEX_NONE;
+
+	float ProfileTime = 0.0f;
+
+	TWeakObjectPtr<AFGPlayer> Player;
+
+	TArray<FFGNetBenchmarkResult> Results;
+
+	//Current profile.
+	int32 NumProxyErrors = 0;
+	double ProxyErrorSum = 0.0;
+
+	int32 NumCorrections = 0;
+	double CorrectionSum = 0.0;
+
+	TSet<uint8> ViewHitRockets;
+
+	TSet<uint8> ServerHitRockets;
+};
@@ -0,0 +1,106 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformProcess.h"
+#include "FGPredictionBenchmarkSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//Extra time the server gets on top of the profiles before the test gives up on it. The server times itself out
+//before this, so this only catches a server that hangs.
+const static float BenchmarkServerTimeout = 180.0f;
+
+//Waits for the benchmark server to exit, its exit code is the bots' verdict.
+class FFGWaitForPredictionBenchmark : public IAutomationLatentCommand
+{
+public:
+
+	FFGWaitForPredictionBenchmark(FAutomationTestBase* InTest, FProcHandle InServerProcess, float InTimeout)
+		: Test(InTest)
+		, ServerProcess(InServerProcess)
+		, Timeout(InTimeout)
+	{}
+
+	virtual bool Update() override
+	{
+		if (FPlatformProcess::IsProcRunning(ServerProcess))
+		{
+			if (GetCurrentRunTime() < Timeout)
+			{
+				return false;
+			}
+
+			FPlatformProcess::TerminateProc(ServerProcess, true);
+			Test->AddError(TEXT("Prediction benchmark server did not exit in time"));
+		}
+
+		else
+		{
+			int32 ReturnCode = 0;
+
+			if (!FPlatformProcess::GetProcReturnCode(ServerProcess, &ReturnCode) || ReturnCode != 0)
+			{
+				Test->AddError(FString::Printf(TEXT("Prediction benchmark failed with exit code %d, the FGNetBot logs say which metric regressed"), ReturnCode));
+			}
+		}
+
+		FPlatformProcess::CloseProc(ServerProcess);
+		return true;
+	}
+
+private:
+
+	FAutomationTestBase* Test = nullptr;
+
+	FProcHandle ServerProcess;
+
+	float Timeout = 0.0f;
+};
+
+//One test per profile. Each starts a dedicated server with -FGNetPredictionBenchmark, which runs the two bot session
+//under that profile, and passes when both bots stayed within the baseline. Started with -FGNetPredictionBaselineUpdate
+//the tests write their profile's baseline instead.
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FFGPredictionBenchmarkTest, "FGNet.PredictionBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FFGPredictionBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FFGNetBenchmarkProfile& Profile : GetDefault<UFGPredictionBenchmarkSubsystem>()->Profiles)
+	{
+		OutBeautifiedNames.Add(Profile.Name);
+		OutTestCommands.Add(Profile.Name);
+	}
+}
+
+bool FFGPredictionBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FString Executable = FPlatformProcess::ExecutablePath();
+	FString Arguments;
+
+#if WITH_EDITOR
+	//The editor executable needs to be told which project to run.
+	Arguments = FString::Printf(TEXT("\"%s\" "), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
+#endif
+
+	Arguments += FString::Printf(TEXT("-server -nullrhi -unattended -FGNetPredictionBenchmark -FGNetPredictionProfile=%s -log=FGNetPredictionBenchmark-%s.log"), *Parameters, *Parameters);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("FGNetPredictionBaselineUpdate")))
+	{
+		Arguments += TEXT(" -FGNetPredictionBaselineUpdate");
+	}
+
+	FProcHandle ServerProcess = FPlatformProcess::CreateProc(*Executable, *Arguments, true, true, true, nullptr, 0, nullptr, nullptr);
+
+	if (!ServerProcess.IsValid())
+	{
+		AddError(FString::Printf(TEXT("Could not start the prediction benchmark server %s"), *Executable));
+		return false;
+	}
+
+	const UFGPredictionBenchmarkSubsystem* Benchmark = GetDefault<UFGPredictionBenchmarkSubsystem>();
+	const float Timeout = Benchmark->WarmupTime + Benchmark->ProfileDuration + BenchmarkServerTimeout;
+	ADD_LATENT_AUTOMATION_COMMAND(FFGWaitForPredictionBenchmark(this, ServerProcess, Timeout));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,6 +4,10 @@
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PlayerState.h"
 #include "Misc/DefaultValueHelper.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Components/PanelWidget.h"
+#include "Components/TextBlock.h"
 
 void UFGNetDebugWidget::UpdateNetworkSimulationSettings(const FFGBlueprintNetworkSimulationSettings& InPackets)
 {
@@ -31,15 +35,112 @@ void UFGNetDebugWidget::UpdateNetworkSimulationSettings(const FFGBlueprintNetwor
 	}
 }
 
+void UFGNetDebugWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	UPanelWidget* RootPanel = Cast<UPanelWidget>(GetRootWidget());
+
+	if (NetStatsText != nullptr || RootPanel == nullptr)
+	{
+		return;
+	}
+
+	NetStatsText = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("NetStatsText"));
+
+	FSlateFontInfo Font = NetStatsText->Font;
+	Font.Size = 10;
+	NetStatsText->SetFont(Font);
+
+	//Top right, out of the way of the simulation settings.
+	if (UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(RootPanel->AddChild(NetStatsText)))
+	{
+		CanvasSlot->SetAnchors(FAnchors(1.0f, 0.0f));
+		CanvasSlot->SetAlignment(FVector2D(1.0f, 0.0f));
+		CanvasSlot->SetPosition(FVector2D(-20.0f, 20.0f));
+		CanvasSlot->SetAutoSize(true);
+	}
+}
+
 void UFGNetDebugWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
-	if (APlayerController* PC = GetOwningPlayer())
+	const UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>();
+
+	//Ping and telemetry change once per sample, not every frame.
+	if (TelemetrySubsystem == nullptr || TelemetrySubsystem->GetSampleVersion() != LastTelemetrySampleVersion)
 	{
-		if (APlayerState* PlayerState = PC->GetPlayerState<APlayerState>())
+		if (APlayerController* PC = GetOwningPlayer())
 		{
-			BP_UpdatePing(static_cast<int32>(PlayerState->GetPing()));
+			if (APlayerState* PlayerState = PC->GetPlayerState<APlayerState>())
+			{
+				BP_UpdatePing(static_cast<int32>(PlayerState->GetPing()));
+			}
 		}
 	}
+
+	if (TelemetrySubsystem != nullptr && TelemetrySubsystem->GetSampleVersion() != LastTelemetrySampleVersion)
+	{
+		LastTelemetrySampleVersion = TelemetrySubsystem->GetSampleVersion();
+
+		TArray<FFGConnectionTelemetry> Telemetry;
+		TelemetrySubsystem->GetLatest(Telemetry);
+		BP_UpdateTelemetry(Telemetry);
+
+		TelemetryReport.Reset();
+
+		for (const FFGConnectionTelemetry& Connection : Telemetry)
+		{
+			TelemetryReport += FString::Printf(TEXT("%s  RTT %.0f ms"), *Connection.Address, Connection.RttMean);
+
+			if (Connection.RttStdDev >= 0.0f)
+			{
+				TelemetryReport += FString::Printf(TEXT(" +-%.0f"), Connection.RttStdDev);
+			}
+
+			TelemetryReport += FString::Printf(TEXT("  jitter %.0f ms  loss in %.1f%% out %.1f%%\n"), Connection.Jitter, Connection.InLoss, Connection.OutLoss);
+		}
+
+		UpdateNetStatsText();
+	}
+
+	const UFGNetTrafficSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UFGNetTrafficSubsystem>();
+
+	if (TrafficSubsystem != nullptr && TrafficSubsystem->GetReportVersion() != LastTrafficReportVersion)
+	{
+		LastTrafficReportVersion = TrafficSubsystem->GetReportVersion();
+
+		TArray<FFGNetConnectionTraffic> Connections;
+		TrafficSubsystem->GetConnections(Connections);
+		BP_UpdateTraffic(TrafficSubsystem->GetEntries(), Connections);
+
+		TrafficReport.Reset();
+
+		for (const FFGNetTrafficEntry& Entry : TrafficSubsystem->GetEntries())
+		{
+			TrafficReport += FString::Printf(TEXT("%s %s  %.1f/s  %d B/s\n"), *Entry.Name.ToString(), *UEnum::GetDisplayValueAsText(Entry.Kind).ToString(), Entry.CallsPerSecond, Entry.BytesPerSecond);
+		}
+
+		for (const FFGNetConnectionTraffic& Connection : Connections)
+		{
+			TrafficReport += FString::Printf(TEXT("%s  in %d B/s  out %d B/s\n"), *Connection.Address, Connection.InBytesPerSecond, Connection.OutBytesPerSecond);
+		}
+
+		UpdateNetStatsText();
+	}
+}
+
+void UFGNetDebugWidget::UpdateNetStatsText()
+{
+	if (NetStatsText != nullptr)
+	{
+		NetStatsText->SetText(FText::FromString(TelemetryReport + TEXT("\n") + TrafficReport));
+	}
+}
+
+FString UFGNetDebugWidget::ExportTrafficCsv()
+{
+	const UFGNetTrafficSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UFGNetTrafficSubsystem>();
+	return TrafficSubsystem != nullptr ? TrafficSubsystem->ExportCsv() : FString();
 }
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Blueprint/UserWidget.h"
+#include "../FGNetTrafficSubsystem.h"
+#include "../FGNetTelemetrySubsystem.h"
 #include "FGNetDebugWidget.generated.h"
 
+class UTextBlock;
+
 USTRUCT(BlueprintType)
 struct FFGBlueprintNetworkSimulationSettings
 {
@@ -55,14 +59,45 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Network SimulationSettings"))
 	void BP_OnUpdateNetworkSimulationSettings(const FFGBlueprintNetworkSimulationSettingsText& Packets);
 
+	virtual void NativeConstruct() override;
+
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Ping"))
 	void BP_UpdatePing(int32 ping);
 
+	//Once a second, every RPC and property this machine sent or received and the traffic of each connection.
+	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Traffic"))
+	void BP_UpdateTraffic(const TArray<FFGNetTrafficEntry>& Entries, const TArray<FFGNetConnectionTraffic>& Connections);
+
+	//At the telemetry sample rate, the quality of every connection this machine has.
+	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Update Telemetry"))
+	void BP_UpdateTelemetry(const TArray<FFGConnectionTelemetry>& Telemetry);
+
+	//Writes the traffic to Saved/Profiling/FGNet and returns the file name.
+	UFUNCTION(BlueprintCallable, Category = Widget)
+	FString ExportTrafficCsv();
+
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Show Widget"))
 	void BP_OnShowWidget();
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Widget, meta = (DisplayName = "On Hide Widget"))
 	void BP_OnHideWidget();
+
+	//Traffic and telemetry as plain text, so they show without the Blueprint implementing the events above. Uses the
+	//text block named NetStatsText if the widget has one, otherwise one is added to the root panel.
+	UPROPERTY(BlueprintReadOnly, Category = Widget, meta = (BindWidgetOptional))
+	UTextBlock* NetStatsText = nullptr;
+
+private:
+
+	void UpdateNetStatsText();
+
+	FString TrafficReport;
+
+	FString TelemetryReport;
+
+	int32 LastTrafficReportVersion = INDEX_NONE;
+
+	int32 LastTelemetrySampleVersion = INDEX_NONE;
 };
@@ -0,0 +1,219 @@
+#include "FGInterestSubsystem.h"
+#include "Engine/World.h"
+#include "FGNet/Player/FGPlayer.h"
+#include "FGNet/Debug/FGNetTelemetrySubsystem.h"
+
+void UFGInterestSubsystem::Deinitialize()
+{
+	Players.Reset();
+	Cells.Reset();
+	Links.Reset();
+	SendRates.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGInterestSubsystem::Tick(float DeltaTime)
+{
+	RebuildGrid();
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (AFGPlayer* Viewer : Players)
+	{
+		//A listen server's own player sees the server state directly.
+		if (Viewer != nullptr && !Viewer->IsLocallyControlled() && Viewer->GetNetConnection() != nullptr)
+		{
+			FFGSendRateController& SendRate = SendRates.FindOrAdd(Viewer);
+			SendMovementUpdates(Viewer, Now, SendRate.Update(Viewer->GetNetConnection(), DeltaTime, MovementSendRateSettings));
+		}
+	}
+}
+
+bool UFGInterestSubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return Players.Num() > 1 && World != nullptr && World->GetNetMode() != NM_Client && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGInterestSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGInterestSubsystem::RegisterPlayer(AFGPlayer* Player)
+{
+	Players.AddUnique(Player);
+}
+
+void UFGInterestSubsystem::UnregisterPlayer(AFGPlayer* Player)
+{
+	Players.Remove(Player);
+	SendRates.Remove(Player);
+
+	for (auto It = Links.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Key == Player || It.Key().Value == Player)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UFGInterestSubsystem::AckMovementUpdate(const AFGPlayer* Viewer, const AFGPlayer* Target, uint8 Sequence, bool bBaselineLost)
+{
+	FFGInterestLink* Link = Links.Find(TPair<const AFGPlayer*, const AFGPlayer*>(Viewer, Target));
+
+	if (Link == nullptr)
+	{
+		return;
+	}
+
+	const uint8 Age = Link->NextSequence - Sequence;
+
+	//Every update is acked once, with the viewer's next move packet, so this includes up to one client send interval.
+	if (Age > 0 && Age <= FFGMovementHistory::Capacity)
+	{
+		if (UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>())
+		{
+			const float SendTime = Link->SendTimes[Sequence % FFGMovementHistory::Capacity];
+			TelemetrySubsystem->AddRttSample(Viewer->GetNetConnection(), GetWorld()->GetRealTimeSeconds() - SendTime);
+		}
+	}
+
+	if (bBaselineLost)
+	{
+		Link->bHasBaseline = false;
+		return;
+	}
+
+	//Acks arrive out of order, only a newer state that is still in the history moves the baseline.
+	const bool bIsNewer = !Link->bHasBaseline || static_cast<int8>(Sequence - Link->BaselineSequence) > 0;
+
+	if (Age > 0 && Age < FFGMovementHistory::Capacity && bIsNewer && Link->SentMovement.Find(Sequence) != nullptr)
+	{
+		Link->BaselineSequence = Sequence;
+		Link->bHasBaseline = true;
+	}
+}
+
+FIntPoint UFGInterestSubsystem::GetCell(const FVector& Location) const
+{
+	const float InvCellSize = 1.0f / FMath::Max(CellSize, 1.0f);
+	return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+}
+
+float UFGInterestSubsystem::GetCullDistance() const
+{
+	//From a corner of the viewer's cell to the far corner of the last cell in range.
+	return FMath::Max(CellSize, 1.0f) * (InterestRadiusInCells + 1) * UE_SQRT_2;
+}
+
+void UFGInterestSubsystem::RebuildGrid()
+{
+	for (TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+	{
+		Cell.Value.Reset();
+	}
+
+	for (int32 Index = 0; Index < Players.Num(); Index++)
+	{
+		if (Players[Index] != nullptr)
+		{
+			Cells.FindOrAdd(GetCell(Players[Index]->GetActorLocation())).Add(Index);
+		}
+	}
+}
+
+void UFGInterestSubsystem::SendMovementUpdates(AFGPlayer* Viewer, float Now, float RateScale)
+{
+	const FVector ViewLocation = Viewer->GetActorLocation();
+	const FIntPoint ViewCell = GetCell(ViewLocation);
+	const float InterestRange = FMath::Max(CellSize * InterestRadiusInCells, 1.0f);
+
+	Candidates.Reset();
+
+	for (int32 Y = ViewCell.Y - InterestRadiusInCells; Y <= ViewCell.Y + InterestRadiusInCells; Y++)
+	{
+		for (int32 X = ViewCell.X - InterestRadiusInCells; X <= ViewCell.X + InterestRadiusInCells; X++)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 Index : *Cell)
+			{
+				AFGPlayer* Target = Players[Index];
+
+				//Owners predict themselves, they never get their own movement back.
+				if (Target == Viewer || !Target->HasServerMovementState())
+				{
+					continue;
+				}
+
+				FFGInterestLink& Link = Links.FindOrAdd(TPair<const AFGPlayer*, const AFGPlayer*>(Viewer, Target));
+
+				if (Target->GetServerMovementState().TimeStamp <= Link.LastSentTimeStamp)
+				{
+					continue;
+				}
+
+				const float Alpha = FMath::Clamp(FVector::Dist2D(ViewLocation, Target->GetActorLocation()) / InterestRange, 0.0f, 1.0f);
+				const float UpdateRate = FMath::Max(FMath::Lerp(MaxMovementUpdateRate, MinMovementUpdateRate, Alpha) * RateScale, MinMovementUpdateRate);
+				const float Overdue = (Now - Link.LastSendTime) * FMath::Max(UpdateRate, KINDA_SMALL_NUMBER);
+
+				if (Overdue >= 1.0f)
+				{
+					Candidates.Add({ Target, Overdue });
+				}
+			}
+		}
+	}
+
+	const int32 MaxUpdates = FMath::Max(FMath::CeilToInt(MaxMovementUpdatesPerViewer * RateScale), 1);
+
+	if (Candidates.Num() > MaxUpdates)
+	{
+		Candidates.Sort([](const FMovementCandidate& A, const FMovementCandidate& B) { return A.Priority > B.Priority; });
+		Candidates.SetNum(MaxUpdates, false);
+	}
+
+	const float RealTime = GetWorld()->GetRealTimeSeconds();
+
+	for (const FMovementCandidate& Candidate : Candidates)
+	{
+		FFGInterestLink& Link = Links.FindChecked(TPair<const AFGPlayer*, const AFGPlayer*>(Viewer, Candidate.Target));
+		Link.LastSendTime = Now;
+		Link.LastSentTimeStamp = Candidate.Target->GetServerMovementState().TimeStamp;
+
+		//Both ends keep the quantized state, so the baselines match exactly.
+		FGMovementData State = Candidate.Target->GetServerMovementState();
+		State.Quantize();
+
+		FFGMovementUpdate Update;
+		Update.Sequence = Link.NextSequence++;
+
+		//Too old and the viewer may have overwritten it, send the full state then.
+		const uint8 BaselineAge = Update.Sequence - Link.BaselineSequence;
+		const FGMovementData* Baseline = Link.bHasBaseline && BaselineAge < FFGMovementHistory::Capacity ? Link.SentMovement.Find(Link.BaselineSequence) : nullptr;
+
+		if (Baseline != nullptr && State.TimeStamp >= Baseline->TimeStamp)
+		{
+			Update.bIsDelta = true;
+			Update.BaselineAge = BaselineAge;
+			Update.Move = State.MakeDelta(*Baseline);
+		}
+
+		else
+		{
+			Update.Move = State;
+		}
+
+		Link.SentMovement.Add(Update.Sequence, State);
+		Link.SendTimes[Update.Sequence % FFGMovementHistory::Capacity] = RealTime;
+		Viewer->Client_ReceiveMovement(Candidate.Target, Update);
+	}
+}
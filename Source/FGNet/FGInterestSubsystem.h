@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGNet/Player/FGSendRateController.h"
+#include "FGNet/Player/FGMovementData.h"
+#include "FGInterestSubsystem.generated.h"
+
+class AFGPlayer;
+
+//What one connection last got about one player.
+struct FFGInterestLink
+{
+	float LastSendTime = -BIG_NUMBER;
+
+	float LastSentTimeStamp = -1.0f;
+
+	//Movement states sent on this link, the viewer acks them to make them the baseline for the next ones.
+	FFGMovementHistory SentMovement;
+
+	//Real time each update in SentMovement went out, by sequence. The acks time the viewer's round trips with it.
+	float SendTimes[FFGMovementHistory::Capacity] = {};
+
+	uint8 NextSequence = 0;
+
+	uint8 BaselineSequence = 0;
+
+	bool bHasBaseline = false;
+};
+
+//Server side interest management. Players are bucketed in a coarse grid, each connection only hears about what is in the
+//cells around it, and movement of far away players is sent less often and with lower priority than that of close ones.
+//Movement goes out as a delta to the newest state the viewer acknowledged, or in full when there is none.
+UCLASS(Config = Game)
+class FGNET_API UFGInterestSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	void RegisterPlayer(AFGPlayer* Player);
+
+	void UnregisterPlayer(AFGPlayer* Player);
+
+	//The viewer got this update about Target, later ones are sent relative to it. Also a round trip sample for the
+	//viewer's connection telemetry.
+	void AckMovementUpdate(const AFGPlayer* Viewer, const AFGPlayer* Target, uint8 Sequence, bool bBaselineLost);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	//Furthest anything in the cells around a viewer can be. The replication graph culls at this and uses the same cell size,
+	//so both agree on what a connection sees, e.g. every player we send movement about exists on that client.
+	float GetCullDistance() const;
+
+	//Also the replication graph's grid cell size.
+	UPROPERTY(Config)
+	float CellSize = 2500.0f;
+
+	//How many cells around its own a connection sees, in each direction.
+	UPROPERTY(Config)
+	int32 InterestRadiusInCells = 4;
+
+	//Movement updates per second for a player right next to the viewer.
+	UPROPERTY(Config)
+	float MaxMovementUpdateRate = 30.0f;
+
+	//Movement updates per second at the edge of the interest range.
+	UPROPERTY(Config)
+	float MinMovementUpdateRate = 4.0f;
+
+	//Per connection and tick, the most overdue updates go first when there are more than this.
+	UPROPERTY(Config)
+	int32 MaxMovementUpdatesPerViewer = 8;
+
+	//Scales the rates and the updates per tick down for connections that are saturated, lossy or queueing.
+	//Never below MinMovementUpdateRate, at the edge of the interest range that is what everyone gets.
+	UPROPERTY(Config)
+	FFGSendRateSettings MovementSendRateSettings;
+
+private:
+
+	struct FMovementCandidate
+	{
+		AFGPlayer* Target = nullptr;
+
+		float Priority = 0.0f;
+	};
+
+	void RebuildGrid();
+
+	void SendMovementUpdates(AFGPlayer* Viewer, float Now, float RateScale);
+
+	UPROPERTY(Transient)
+	TArray<AFGPlayer*> Players;
+
+	//Indices into Players, rebuilt every tick.
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	TMap<TPair<const AFGPlayer*, const AFGPlayer*>, FFGInterestLink> Links;
+
+	//Per viewer, for its connection.
+	TMap<const AFGPlayer*, FFGSendRateController> SendRates;
+
+	//Reused every tick.
+	TArray<FMovementCandidate> Candidates;
+};
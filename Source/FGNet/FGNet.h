@@ -4,3 +4,6 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogFGNet, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("FGNet"), STATGROUP_FGNet, STATCAT_Advanced);
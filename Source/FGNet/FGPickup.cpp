@@ -1,14 +1,15 @@
 #include "FGPickup.h"
-#include "Player/FGPlayer.h"
+#include "FGPickupManager.h"
+#include "FGPickupSubsystem.h"
+#include "FGPickupAnimatorSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
-#include "TimerManager.h"
 
 AFGPickup::AFGPickup()
 {
-	PrimaryActorTick.bStartWithTickEnabled = true;
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.bCanEverTick = false;
 
 	SceneComp = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
 
@@ -16,52 +17,60 @@ AFGPickup::AFGPickup()
 
 	SphereComponent = CreateDefaultSubobject<USphereComponent>(TEXT("Sphere"));
 	SphereComponent->SetupAttachment(RootComponent);
+	SphereComponent->SetGenerateOverlapEvents(false);
+	SphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
 
 	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	MeshComponent->SetupAttachment(RootComponent);
 	MeshComponent->SetGenerateOverlapEvents(false);
 	MeshComponent->SetCollisionProfileName(TEXT("NoCollision"));
 
-	SetReplicates(true);
+	//State is replicated through AFGPickupManager, the pickup itself is only loaded with the level.
+	SetReplicates(false);
 }
 
 void AFGPickup::BeginPlay()
 {
 	Super::BeginPlay();
 
-	SphereComponent->OnComponentBeginOverlap.AddDynamic(this, &AFGPickup::OverlapBegin);
-	CachedMeshRelativeLocation = MeshComponent->GetRelativeLocation();
+	if (UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>())
+	{
+		PickupSubsystem->RegisterPickup(this);
+	}
+
+	if (UFGPickupAnimatorSubsystem* AnimatorSubsystem = GetWorld()->GetSubsystem<UFGPickupAnimatorSubsystem>())
+	{
+		AnimatorSubsystem->AddMesh(MeshComponent);
+	}
+
+	if (GetNetMode() != NM_Client)
+	{
+		if (AFGPickupManager* PickupManager = AFGPickupManager::Get(GetWorld()))
+		{
+			PickupManager->RegisterPickup(this);
+		}
+	}
 }
 
 void AFGPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	if (const UWorld* World = GetWorld())
+	if (UFGPickupAnimatorSubsystem* AnimatorSubsystem = GetWorld()->GetSubsystem<UFGPickupAnimatorSubsystem>())
 	{
-		World->GetTimerManager().ClearTimer(ReActivateHandle);
+		AnimatorSubsystem->RemoveMesh(MeshComponent);
 	}
-}
-
-
-void AFGPickup::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-	const float PulsatingValue = FMath::MakePulsatingValue(GetWorld()->GetTimeSeconds(), 0.65f) * 30.0f;
-	const FVector NewLocation = CachedMeshRelativeLocation + FVector(0.0f, 0.0f, PulsatingValue);
 
-	FHitResult Hit;
-	MeshComponent->SetRelativeLocation(NewLocation, false, &Hit, ETeleportType::TeleportPhysics);
-	MeshComponent->AddRelativeRotation(FRotator(0.0f, 20.0f * DeltaTime, 0.0f), false, &Hit, ETeleportType::TeleportPhysics);
+	if (UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>())
+	{
+		PickupSubsystem->UnregisterPickup(this);
+	}
 }
 
-void AFGPickup::ReActivatePickup()
+void AFGPickup::SetActive(bool bNewActive)
 {
-	bPickedUp = false;
-	//RootComponent->SetVisibility(true, true);
-	SetVisibility(true);
-	SphereComponent->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
-	SetActorTickEnabled(true);
+	bPickedUp = !bNewActive;
+	SetVisibility(bNewActive);
 }
 
 void AFGPickup::SetVisibility(bool NewVisible)
@@ -69,24 +78,6 @@ void AFGPickup::SetVisibility(bool NewVisible)
 	RootComponent->SetVisibility(NewVisible, true);
 }
 
-void AFGPickup::OverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	if (bPickedUp)
-	{
-		return;
-	}
-
-	if (AFGPlayer* Player = Cast<AFGPlayer>(OtherActor))
-	{
-		Player->OnPickup(this);
-		bPickedUp = true;
-		SphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
-		RootComponent->SetVisibility(false, true);
-		GetWorldTimerManager().SetTimer(ReActivateHandle, this, &AFGPickup::ReActivatePickup, ReActivateTime, false);
-		SetActorTickEnabled(false);
-	}
-}
-
 bool AFGPickup::GetIsPickedUp()
 {
 	return bPickedUp;
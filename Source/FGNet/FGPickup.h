@@ -26,12 +26,10 @@ public:
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	virtual void Tick(float DeltaTime) override;
-
 	bool GetIsPickedUp();
 
-	UFUNCTION()
-	void ReActivatePickup();
+	//Shows or hides the pickup. The state itself lives in AFGPickupManager, this is only what this machine sees.
+	void SetActive(bool bNewActive);
 
 	UFUNCTION()
 	void SetVisibility(bool NewVisible);
@@ -41,6 +39,7 @@ public:
 	UPROPERTY()
 	USceneComponent* SceneComp;
 
+	//Only its radius is used, UFGPickupSubsystem tests players against it without any collision.
 	UPROPERTY(VisibleDefaultsOnly, Category = Collision)
 	USphereComponent* SphereComponent;
 
@@ -58,16 +57,14 @@ public:
 
 private:
 
-	FVector CachedMeshRelativeLocation = FVector::ZeroVector;
+	friend class AFGPickupManager;
+	friend class UFGPickupSubsystem;
 
-	FTimerHandle ReActivateHandle;
+	//Where the manager keeps this pickup's state, set on the server.
+	int32 StateIndex = INDEX_NONE;
 
-	bool bPickedUp = false;
-
-private:
+	//Where UFGPickupSubsystem keeps this pickup.
+	int32 PickupIndex = INDEX_NONE;
 
-
-
-	UFUNCTION()
-	void OverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	bool bPickedUp = false;
 };
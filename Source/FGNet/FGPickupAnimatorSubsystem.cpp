@@ -0,0 +1,72 @@
+#include "FGPickupAnimatorSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+
+bool UFGPickupAnimatorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningDedicatedServer();
+}
+
+void UFGPickupAnimatorSubsystem::Deinitialize()
+{
+	Meshes.Reset();
+	BaseLocations.Reset();
+	BaseRotations.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGPickupAnimatorSubsystem::Tick(float DeltaTime)
+{
+	//Every pickup is in the same phase, so the offset is the same for all of them.
+	const FVector Offset(0.0f, 0.0f, FMath::MakePulsatingValue(GetWorld()->GetTimeSeconds(), BobFrequency) * BobHeight);
+	SpinYaw = FMath::Fmod(SpinYaw + SpinRate * DeltaTime, 360.0f);
+
+	for (int32 Index = 0; Index < Meshes.Num(); Index++)
+	{
+		UStaticMeshComponent* Mesh = Meshes[Index];
+
+		//Picked up pickups are hidden, nobody sees them move.
+		if (Mesh == nullptr || !Mesh->IsVisible())
+		{
+			continue;
+		}
+
+		const FRotator Rotation(BaseRotations[Index].Pitch, BaseRotations[Index].Yaw + SpinYaw, BaseRotations[Index].Roll);
+		Mesh->SetRelativeLocationAndRotation(BaseLocations[Index] + Offset, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+}
+
+bool UFGPickupAnimatorSubsystem::IsTickable() const
+{
+	return Meshes.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGPickupAnimatorSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGPickupAnimatorSubsystem::AddMesh(UStaticMeshComponent* Mesh)
+{
+	if (Mesh == nullptr || Meshes.Contains(Mesh))
+	{
+		return;
+	}
+
+	Meshes.Add(Mesh);
+	BaseLocations.Add(Mesh->GetRelativeLocation());
+	BaseRotations.Add(Mesh->GetRelativeRotation());
+}
+
+void UFGPickupAnimatorSubsystem::RemoveMesh(UStaticMeshComponent* Mesh)
+{
+	const int32 Index = Meshes.Find(Mesh);
+
+	if (Index != INDEX_NONE)
+	{
+		Meshes.RemoveAtSwap(Index);
+		BaseLocations.RemoveAtSwap(Index);
+		BaseRotations.RemoveAtSwap(Index);
+	}
+}
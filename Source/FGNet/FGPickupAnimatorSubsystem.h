@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGPickupAnimatorSubsystem.generated.h"
+
+class UStaticMeshComponent;
+
+//Bobs and spins the mesh of every pickup in one tick instead of one tick per pickup. Purely cosmetic, so it does not
+//exist on a dedicated server.
+UCLASS(Config = Game)
+class FGNET_API UFGPickupAnimatorSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	//The mesh bobs around where it is now.
+	void AddMesh(UStaticMeshComponent* Mesh);
+
+	void RemoveMesh(UStaticMeshComponent* Mesh);
+
+	UPROPERTY(Config)
+	float BobHeight = 30.0f;
+
+	UPROPERTY(Config)
+	float BobFrequency = 0.65f;
+
+	//Degrees per second.
+	UPROPERTY(Config)
+	float SpinRate = 20.0f;
+
+private:
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> Meshes;
+
+	TArray<FVector> BaseLocations;
+
+	TArray<FRotator> BaseRotations;
+
+	//Shared by every mesh, each spins from its own base rotation.
+	float SpinYaw = 0.0f;
+};
@@ -0,0 +1,165 @@
+#include "FGPickupManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Net/UnrealNetwork.h"
+#include "FGPickupSubsystem.h"
+#include "Debug/FGNetTrafficSubsystem.h"
+
+void FFGPickupState::PostReplicatedAdd(const FFGPickupStateArray& InArraySerializer)
+{
+	if (Pickup != nullptr)
+	{
+		Pickup->SetActive(bActive);
+	}
+
+	AFGPickupManager::RecordReceivedState(*this);
+}
+
+void FFGPickupState::PostReplicatedChange(const FFGPickupStateArray& InArraySerializer)
+{
+	if (Pickup != nullptr)
+	{
+		Pickup->SetActive(bActive);
+	}
+
+	AFGPickupManager::RecordReceivedState(*this);
+}
+
+AFGPickupManager::AFGPickupManager()
+{
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetReplicates(true);
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 10.0f;
+}
+
+void AFGPickupManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AFGPickupManager, PickupStates);
+}
+
+AFGPickupManager* AFGPickupManager::Get(UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (TActorIterator<AFGPickupManager> It(World); It; ++It)
+	{
+		return *It;
+	}
+
+	if (World->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	return World->SpawnActor<AFGPickupManager>();
+}
+
+void AFGPickupManager::RegisterPickup(AFGPickup* Pickup)
+{
+	if (Pickup == nullptr || FindState(Pickup) != nullptr)
+	{
+		return;
+	}
+
+	FFGPickupState& State = PickupStates.Items.AddDefaulted_GetRef();
+	State.Pickup = Pickup;
+	State.Type = Pickup->PickupType;
+	State.Amount = Pickup->NumRockets;
+	MarkStateDirty(State);
+
+	Pickup->StateIndex = PickupStates.Items.Num() - 1;
+}
+
+bool AFGPickupManager::TryCollect(AFGPickup* Pickup)
+{
+	FFGPickupState* State = FindState(Pickup);
+
+	if (State == nullptr || !State->bActive)
+	{
+		return false;
+	}
+
+	State->bActive = false;
+	State->RespawnTime = GetWorld()->GetTimeSeconds() + Pickup->ReActivateTime;
+	MarkStateDirty(*State);
+
+	Pickup->SetActive(false);
+
+	if (UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>())
+	{
+		PickupSubsystem->ScheduleRespawn(Pickup, Pickup->ReActivateTime);
+	}
+
+	return true;
+}
+
+void AFGPickupManager::RespawnPickup(AFGPickup* Pickup)
+{
+	FFGPickupState* State = FindState(Pickup);
+
+	if (State == nullptr || State->bActive)
+	{
+		return;
+	}
+
+	State->bActive = true;
+	MarkStateDirty(*State);
+
+	Pickup->SetActive(true);
+}
+
+void AFGPickupManager::ResendState(AFGPickup* Pickup)
+{
+	if (FFGPickupState* State = FindState(Pickup))
+	{
+		MarkStateDirty(*State);
+	}
+}
+
+void AFGPickupManager::MarkStateDirty(FFGPickupState& State)
+{
+	PickupStates.MarkItemDirty(State);
+
+#if FGNET_TRAFFIC_STATS
+	if (UFGNetTrafficSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UFGNetTrafficSubsystem>())
+	{
+		TrafficSubsystem->Record(GET_MEMBER_NAME_CHECKED(AFGPickupManager, PickupStates), EFGNetTrafficKind::Property, UFGNetTrafficSubsystem::MeasureStructBits(FFGPickupState::StaticStruct(), &State));
+	}
+#endif
+}
+
+void AFGPickupManager::RecordReceivedState(const FFGPickupState& State)
+{
+#if FGNET_TRAFFIC_STATS
+	UWorld* World = State.Pickup != nullptr ? State.Pickup->GetWorld() : nullptr;
+
+	if (UFGNetTrafficSubsystem* TrafficSubsystem = World != nullptr ? World->GetSubsystem<UFGNetTrafficSubsystem>() : nullptr)
+	{
+		TrafficSubsystem->Record(GET_MEMBER_NAME_CHECKED(AFGPickupManager, PickupStates), EFGNetTrafficKind::PropertyIn, UFGNetTrafficSubsystem::MeasureStructBits(FFGPickupState::StaticStruct(), &State));
+	}
+#endif
+}
+
+FFGPickupState* AFGPickupManager::FindState(const AFGPickup* Pickup)
+{
+	if (Pickup == nullptr)
+	{
+		return nullptr;
+	}
+
+	//Pickups remember where their state is, anything else falls back to a search.
+	if (PickupStates.Items.IsValidIndex(Pickup->StateIndex) && PickupStates.Items[Pickup->StateIndex].Pickup == Pickup)
+	{
+		return &PickupStates.Items[Pickup->StateIndex];
+	}
+
+	return PickupStates.Items.FindByPredicate([Pickup](const FFGPickupState& State) { return State.Pickup == Pickup; });
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "FGPickup.h"
+#include "FGPickupManager.generated.h"
+
+//Server owned state of one pickup. Only entries that changed are sent.
+USTRUCT()
+struct FFGPickupState : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	//Pickups are placed in the level and not replicated themselves, they are referenced by their stable name.
+	UPROPERTY()
+	AFGPickup* Pickup = nullptr;
+
+	UPROPERTY()
+	EFGPickupType Type = EFGPickupType::Rocket;
+
+	UPROPERTY()
+	int32 Amount = 0;
+
+	UPROPERTY()
+	bool bActive = true;
+
+	//Server world time the pickup comes back, only meaningful while it is not active.
+	UPROPERTY()
+	float RespawnTime = 0.0f;
+
+	void PostReplicatedAdd(const struct FFGPickupStateArray& InArraySerializer);
+	void PostReplicatedChange(const struct FFGPickupStateArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FFGPickupStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FFGPickupState> Items;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FFGPickupState, FFGPickupStateArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGPickupStateArray> : public TStructOpsTypeTraitsBase2<FFGPickupStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+//Owns the state of every pickup in the level, so they all share one actor channel instead of one each.
+//The server spawns it when the first pickup asks for it.
+UCLASS()
+class FGNET_API AFGPickupManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AFGPickupManager();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	//On clients this is nullptr until the manager has replicated.
+	static AFGPickupManager* Get(UWorld* World);
+
+	void RegisterPickup(AFGPickup* Pickup);
+
+	//Server only. Returns false when the pickup is already taken, otherwise its respawn is scheduled.
+	bool TryCollect(AFGPickup* Pickup);
+
+	//Server only, called by UFGPickupSubsystem when the respawn is due.
+	void RespawnPickup(AFGPickup* Pickup);
+
+	//Server only, sends the pickup's state again for a client that hid it on a claim the server turned down.
+	void ResendState(AFGPickup* Pickup);
+
+	int32 GetNumPickups() const { return PickupStates.Items.Num(); }
+
+	//Client side counterpart of the traffic MarkStateDirty records, for a state that arrived.
+	static void RecordReceivedState(const FFGPickupState& State);
+
+private:
+
+	FFGPickupState* FindState(const AFGPickup* Pickup);
+
+	void MarkStateDirty(FFGPickupState& State);
+
+	UPROPERTY(Replicated)
+	FFGPickupStateArray PickupStates;
+};
@@ -0,0 +1,227 @@
+#include "FGPickupSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "FGPickup.h"
+#include "FGPickupManager.h"
+#include "FGNet/Player/FGPlayer.h"
+
+void UFGPickupSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	RespawnWheel.SetNum(FMath::Max(NumRespawnWheelSlots, 1));
+}
+
+void UFGPickupSubsystem::Deinitialize()
+{
+	Pickups.Reset();
+	Locations.Reset();
+	Radii.Reset();
+	Cells.Reset();
+	Players.Reset();
+	RespawnWheel.Reset();
+	NumScheduledRespawns = 0;
+
+	Super::Deinitialize();
+}
+
+void UFGPickupSubsystem::Tick(float DeltaTime)
+{
+	for (AFGPlayer* Player : Players)
+	{
+		//Everyone else's pickups are decided by the server and arrive through the pickup manager.
+		if (Player != nullptr && Player->IsLocallyControlled())
+		{
+			CollectPickups(Player);
+		}
+	}
+
+	if (NumScheduledRespawns > 0)
+	{
+		AdvanceRespawnWheel(DeltaTime);
+	}
+}
+
+bool UFGPickupSubsystem::IsTickable() const
+{
+	return ((Players.Num() > 0 && Pickups.Num() > 0) || NumScheduledRespawns > 0) && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGPickupSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGPickupSubsystem::RegisterPickup(AFGPickup* Pickup)
+{
+	if (Pickup == nullptr || FindPickupIndex(Pickup) != INDEX_NONE)
+	{
+		return;
+	}
+
+	const float Radius = Pickup->SphereComponent->GetScaledSphereRadius();
+	const int32 Index = Pickups.Add(Pickup);
+	Locations.Add(Pickup->SphereComponent->GetComponentLocation());
+	Radii.Add(Radius);
+	MaxPickupRadius = FMath::Max(MaxPickupRadius, Radius);
+
+	Cells.FindOrAdd(GetCell(Locations[Index])).Add(Index);
+
+	Pickup->PickupIndex = Index;
+}
+
+void UFGPickupSubsystem::UnregisterPickup(AFGPickup* Pickup)
+{
+	const int32 Index = FindPickupIndex(Pickup);
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (TArray<int32>* Cell = Cells.Find(GetCell(Locations[Index])))
+	{
+		Cell->RemoveSingleSwap(Index);
+	}
+
+	Pickups[Index] = nullptr;
+	Pickup->PickupIndex = INDEX_NONE;
+}
+
+void UFGPickupSubsystem::RegisterPlayer(AFGPlayer* Player)
+{
+	Players.AddUnique(Player);
+}
+
+void UFGPickupSubsystem::UnregisterPlayer(AFGPlayer* Player)
+{
+	Players.Remove(Player);
+}
+
+bool UFGPickupSubsystem::IsInReach(const AFGPickup* Pickup, const FVector& Location, float PlayerRadius, float Tolerance) const
+{
+	const int32 Index = FindPickupIndex(Pickup);
+
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const float Reach = Radii[Index] + PlayerRadius + Tolerance;
+	return FVector::DistSquared(Locations[Index], Location) <= FMath::Square(Reach);
+}
+
+void UFGPickupSubsystem::ScheduleRespawn(AFGPickup* Pickup, float Delay)
+{
+	const int32 PickupIndex = FindPickupIndex(Pickup);
+
+	if (PickupIndex == INDEX_NONE || RespawnWheel.Num() == 0)
+	{
+		return;
+	}
+
+	//Steps from the current slot. A full turn lands back on the current slot, which is handled last.
+	const int32 NumSlots = RespawnWheel.Num();
+	const int32 Steps = FMath::Max(FMath::CeilToInt(Delay / FMath::Max(RespawnWheelSlotTime, KINDA_SMALL_NUMBER)), 1);
+
+	FFGRespawnWheelEntry Entry;
+	Entry.PickupIndex = PickupIndex;
+	Entry.Rounds = (Steps - 1) / NumSlots;
+
+	RespawnWheel[(RespawnWheelCursor + Steps) % NumSlots].Add(Entry);
+	NumScheduledRespawns++;
+}
+
+int32 UFGPickupSubsystem::FindPickupIndex(const AFGPickup* Pickup) const
+{
+	if (Pickup != nullptr && Pickups.IsValidIndex(Pickup->PickupIndex) && Pickups[Pickup->PickupIndex] == Pickup)
+	{
+		return Pickup->PickupIndex;
+	}
+
+	return INDEX_NONE;
+}
+
+FIntPoint UFGPickupSubsystem::GetCell(const FVector& Location) const
+{
+	const float InvCellSize = 1.0f / FMath::Max(CellSize, 1.0f);
+	return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+}
+
+void UFGPickupSubsystem::CollectPickups(AFGPlayer* Player)
+{
+	const FVector PlayerLocation = Player->GetActorLocation();
+	const float PlayerRadius = Player->GetCollisionRadius();
+	const FIntPoint PlayerCell = GetCell(PlayerLocation);
+	const int32 SearchRadius = FMath::CeilToInt((MaxPickupRadius + PlayerRadius) / FMath::Max(CellSize, 1.0f));
+
+	for (int32 Y = PlayerCell.Y - SearchRadius; Y <= PlayerCell.Y + SearchRadius; Y++)
+	{
+		for (int32 X = PlayerCell.X - SearchRadius; X <= PlayerCell.X + SearchRadius; X++)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 Index : *Cell)
+			{
+				AFGPickup* Pickup = Pickups[Index];
+
+				if (Pickup == nullptr || Pickup->GetIsPickedUp())
+				{
+					continue;
+				}
+
+				if (FVector::DistSquared(Locations[Index], PlayerLocation) <= FMath::Square(Radii[Index] + PlayerRadius))
+				{
+					//Hidden right away, the server says whether we really got it.
+					Pickup->SetActive(false);
+					Player->OnPickup(Pickup);
+				}
+			}
+		}
+	}
+}
+
+void UFGPickupSubsystem::AdvanceRespawnWheel(float DeltaTime)
+{
+	AFGPickupManager* PickupManager = AFGPickupManager::Get(GetWorld());
+	const float SlotTime = FMath::Max(RespawnWheelSlotTime, KINDA_SMALL_NUMBER);
+	RespawnWheelTime += DeltaTime;
+
+	while (RespawnWheelTime >= SlotTime && NumScheduledRespawns > 0)
+	{
+		RespawnWheelTime -= SlotTime;
+		RespawnWheelCursor = (RespawnWheelCursor + 1) % RespawnWheel.Num();
+
+		TArray<FFGRespawnWheelEntry>& Slot = RespawnWheel[RespawnWheelCursor];
+
+		for (int32 Index = Slot.Num() - 1; Index >= 0; Index--)
+		{
+			if (Slot[Index].Rounds > 0)
+			{
+				Slot[Index].Rounds--;
+				continue;
+			}
+
+			AFGPickup* Pickup = Pickups[Slot[Index].PickupIndex];
+
+			if (Pickup != nullptr && PickupManager != nullptr)
+			{
+				PickupManager->RespawnPickup(Pickup);
+			}
+
+			Slot.RemoveAtSwap(Index, 1, false);
+			NumScheduledRespawns--;
+		}
+	}
+
+	//Nothing left to wait for, the wheel starts from a fresh slot next time.
+	if (NumScheduledRespawns == 0)
+	{
+		RespawnWheelTime = 0.0f;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGPickupSubsystem.generated.h"
+
+class AFGPickup;
+class AFGPlayer;
+
+//A respawn that is due once the wheel has gone around Rounds more times.
+struct FFGRespawnWheelEntry
+{
+	int32 PickupIndex = INDEX_NONE;
+
+	int32 Rounds = 0;
+};
+
+//Finds which pickups players touch without physics. Pickups never move, so they are hashed into a grid once, and every
+//frame each locally controlled player only tests the pickups in the cells around it.
+//On the server it also respawns collected pickups from a single timing wheel instead of a timer per pickup.
+UCLASS(Config = Game)
+class FGNET_API UFGPickupSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	void RegisterPickup(AFGPickup* Pickup);
+
+	void UnregisterPickup(AFGPickup* Pickup);
+
+	void RegisterPlayer(AFGPlayer* Player);
+
+	void UnregisterPlayer(AFGPlayer* Player);
+
+	//Whether a player at Location could have touched the pickup, Tolerance is added to the reach.
+	bool IsInReach(const AFGPickup* Pickup, const FVector& Location, float PlayerRadius, float Tolerance) const;
+
+	//Server only, the pickup manager is told to respawn the pickup after Delay seconds.
+	void ScheduleRespawn(AFGPickup* Pickup, float Delay);
+
+	UPROPERTY(Config)
+	float CellSize = 1000.0f;
+
+	//Respawns are rounded up to this.
+	UPROPERTY(Config)
+	float RespawnWheelSlotTime = 0.25f;
+
+	//Respawns further out than one turn of the wheel wait for more rounds.
+	UPROPERTY(Config)
+	int32 NumRespawnWheelSlots = 64;
+
+private:
+
+	int32 FindPickupIndex(const AFGPickup* Pickup) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void CollectPickups(AFGPlayer* Player);
+
+	void AdvanceRespawnWheel(float DeltaTime);
+
+	UPROPERTY(Transient)
+	TArray<AFGPickup*> Pickups;
+
+	//Parallel to Pickups, unregistered pickups leave a hole so indices stay valid.
+	TArray<FVector> Locations;
+
+	TArray<float> Radii;
+
+	//Indices into Pickups.
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	float MaxPickupRadius = 0.0f;
+
+	UPROPERTY(Transient)
+	TArray<AFGPlayer*> Players;
+
+	TArray<TArray<FFGRespawnWheelEntry>> RespawnWheel;
+
+	int32 RespawnWheelCursor = 0;
+
+	float RespawnWheelTime = 0.0f;
+
+	int32 NumScheduledRespawns = 0;
+};
@@ -0,0 +1,159 @@
+#include "FGReplicationGraph.h"
+#include "ReplicationGraphTypes.h"
+#include "Engine/NetDriver.h"
+#include "UObject/UObjectIterator.h"
+#include "Player/FGPlayer.h"
+#include "FGPickupManager.h"
+#include "FGInterestSubsystem.h"
+
+void UFGReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	//Configured classes first, everything else is mapped from its defaults below.
+	for (const FFGRepGraphClassSetting& ClassSetting : ClassSettings)
+	{
+		if (UClass* Class = ClassSetting.ActorClass.TryLoadClass<AActor>())
+		{
+			ClassRepNodePolicies.Set(Class, ClassSetting.Mapping);
+		}
+	}
+
+	ClassRepNodePolicies.Set(AFGPlayer::StaticClass(), EFGClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AFGPickupManager::StaticClass(), EFGClassRepNodeMapping::RelevantAllConnections);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		//Skeleton and reinstanced blueprint classes.
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const EFGClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		ClassRepNodePolicies.Set(Class, Mapping);
+
+		const bool bSpatialize = Mapping >= EFGClassRepNodeMapping::Spatialize_Static;
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UFGReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GetDefault<UFGInterestSubsystem>()->CellSize;
+	GridNode->SpatialBias = SpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UFGReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	//The connection's own controller, pawn and view target, owner only state travels with them.
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+void UFGReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+		case EFGClassRepNodeMapping::RelevantAllConnections:
+			AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Static:
+			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Dynamic:
+			GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Dormancy:
+			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+			break;
+
+		default:
+			break;
+	}
+}
+
+void UFGReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+		case EFGClassRepNodeMapping::RelevantAllConnections:
+			AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Static:
+			GridNode->RemoveActor_Static(ActorInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Dynamic:
+			GridNode->RemoveActor_Dynamic(ActorInfo);
+			break;
+
+		case EFGClassRepNodeMapping::Spatialize_Dormancy:
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+			break;
+
+		default:
+			break;
+	}
+}
+
+EFGClassRepNodeMapping UFGReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EFGClassRepNodeMapping* Mapping = ClassRepNodePolicies.Get(Class))
+	{
+		return *Mapping;
+	}
+
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EFGClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EFGClassRepNodeMapping::NotRouted;
+	}
+
+	if (ActorCDO->NetDormancy >= DORM_DormantAll)
+	{
+		return EFGClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	return ActorCDO->IsReplicatingMovement() ? EFGClassRepNodeMapping::Spatialize_Dynamic : EFGClassRepNodeMapping::Spatialize_Static;
+}
+
+void UFGReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const
+{
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+
+	if (bSpatialize)
+	{
+		Info.CullDistanceSquared = FMath::Square(GetDefault<UFGInterestSubsystem>()->GetCullDistance());
+	}
+
+	const float NetServerMaxTickRate = NetDriver != nullptr ? static_cast<float>(NetDriver->NetServerMaxTickRate) : 30.0f;
+	Info.ReplicationPeriodFrame = FMath::Max<uint32>(static_cast<uint32>(FMath::RoundToFloat(NetServerMaxTickRate / FMath::Max(ActorCDO->NetUpdateFrequency, 1.0f))), 1);
+}
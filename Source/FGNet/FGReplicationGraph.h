@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "FGReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+UENUM()
+enum class EFGClassRepNodeMapping : uint8
+{
+	//Not routed to a global node, e.g. only relevant to its owner through the per connection node.
+	NotRouted,
+	RelevantAllConnections,
+	//Spatialized and never moves.
+	Spatialize_Static,
+	//Spatialized and moves every frame.
+	Spatialize_Dynamic,
+	//Spatialized, stays put while dormant and moves while awake.
+	Spatialize_Dormancy,
+};
+
+USTRUCT()
+struct FFGRepGraphClassSetting
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FSoftClassPath ActorClass;
+
+	UPROPERTY()
+	EFGClassRepNodeMapping Mapping = EFGClassRepNodeMapping::Spatialize_Dynamic;
+};
+
+//Replication graph for the server. Players go in a spatial grid, the pickup manager to every connection, and everything
+//the owning connection needs regardless of distance in a per connection node. Enabled and configured in DefaultEngine.ini.
+//The grid's cell size and cull distance come from UFGInterestSubsystem, so relevancy and movement interest always match.
+UCLASS(Transient, Config = Engine)
+class FGNET_API UFGReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	//Lowest world X and Y we expect actors at, the grid starts there.
+	UPROPERTY(Config)
+	FVector2D SpatialBias = FVector2D(-150000.0f, -150000.0f);
+
+	//Classes that should not get the mapping derived from their defaults.
+	UPROPERTY(Config)
+	TArray<FFGRepGraphClassSetting> ClassSettings;
+
+private:
+
+	EFGClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode = nullptr;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode = nullptr;
+
+	TClassMap<EFGClassRepNodeMapping> ClassRepNodePolicies;
+};
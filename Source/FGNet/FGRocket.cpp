@@ -2,13 +2,12 @@
 #include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
-#include "DrawDebugHelpers.h"
-#include "FGNet/Player/FGPlayer.h"
+#include "FGRocketSubsystem.h"
 
 UFGRocket::UFGRocket()
 {
-	PrimaryComponentTick.bStartWithTickEnabled = false;
-	PrimaryComponentTick.bCanEverTick = true;
+	//Moved by UFGRocketSubsystem, rockets never tick on their own.
+	PrimaryComponentTick.bCanEverTick = false;
 
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneCompRoot"));
 	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
@@ -23,85 +22,31 @@ UFGRocket::UFGRocket()
 void UFGRocket::BeginPlay()
 {
 	Super::BeginPlay();
-	CachedCollisionQueryParams.AddIgnoredComponent(this);
 	SetRocketVisibility(false);
 }
 
-void UFGRocket::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UFGRocket::StartMoving(const FFGRocketFireEvent& FireEvent, AFGPlayer* Shooter, float RewindTime)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SetWorldLocationAndRotation(FireEvent.Origin, FireEvent.Direction.Rotation());
 
-	LifeTimeElapsed -= DeltaTime;
-	DistanceMoved += MovementVelocity * DeltaTime;
-
-	FacingRotationStart = FQuat::Slerp(FacingRotationStart.ToOrientationQuat(), FacingRotationCorrection, 0.9f * DeltaTime).Vector(); 
-
-#if !UE_BUILD_SHIPPING
-
-	if (bDebugDrawCorrection)
-	{
-		const float ArrowLength = 3000.0f;
-		const float ArrowSize = 50.0f;
-
-		DrawDebugDirectionalArrow(GetWorld(), RocketStartLocation, RocketStartLocation + OriginalFacingDirection * ArrowLength, ArrowSize, FColor::Red);
-		DrawDebugDirectionalArrow(GetWorld(), RocketStartLocation, RocketStartLocation + FacingRotationStart * ArrowLength, ArrowSize, FColor::Green);
-	}
-
-#endif // !UE_BUILD_SHIPPING
-
-	const FVector NewLocation = RocketStartLocation + FacingRotationStart * DistanceMoved;
-
-	SetWorldLocation(NewLocation);
-	FHitResult Hit;
-
-	const FVector StartLocation = NewLocation;
-	const FVector EndLocation = StartLocation + FacingRotationStart * 100.0f;
-	GetWorld()->LineTraceSingleByChannel(Hit, StartLocation, EndLocation, ECC_Visibility, CachedCollisionQueryParams);
+	//SetRelativeLocation(InStartLocation);
+	//SetRelativeRotation(Forward.Rotation());
 
-	if (Cast<AFGPlayer>(Hit.Actor))
-	{
-		AFGPlayer* HitPlayer;
-		HitPlayer = Cast<AFGPlayer>(Hit.Actor);
-		HitPlayer->OnHit(DamageAmount);
-		Explode();
-		return;
-	}
+	bIsFree = false;
+	//SetRocketVisibility(true);
 
-	if (Hit.bBlockingHit)
+	//Keep the predicted direction around for the debug arrows when the server's path replaces it.
+	if (SimulationIndex == INDEX_NONE)
 	{
-		Explode();
+		OriginalFacingDirection = FireEvent.Direction;
 	}
 
-	if (LifeTimeElapsed < 0.0f)
+	if (UFGRocketSubsystem* RocketSubsystem = GetRocketSubsystem())
 	{
-		Explode();
+		RocketSubsystem->AddRocket(this, FireEvent, Shooter, RewindTime);
 	}
 }
 
-void UFGRocket::StartMoving(const FVector& Forward, const FVector& InStartLocation)
-{
-	FacingRotationStart = Forward;
-	FacingRotationCorrection = FacingRotationStart.ToOrientationQuat();
-	RocketStartLocation = InStartLocation;
-
-	SetWorldLocationAndRotation(InStartLocation, Forward.Rotation());
-
-	//SetRelativeLocation(InStartLocation);
-	//SetRelativeRotation(Forward.Rotation());
-
-	bIsFree = false;
-	SetComponentTickEnabled(true);
-	//SetRocketVisibility(true);
-	LifeTimeElapsed = LifeTime;
-	DistanceMoved = 0.0f;
-	OriginalFacingDirection = FacingRotationStart;
-}
-
-void UFGRocket::ApplyCorrection(const FVector& Forward)
-{
-	FacingRotationCorrection = Forward.ToOrientationQuat();
-}
-
 void UFGRocket::Explode()
 {
 	if (Explosion != nullptr)
@@ -114,13 +59,28 @@ void UFGRocket::Explode()
 
 void UFGRocket::MakeFree()
 {
+	if (bIsFree)
+	{
+		return;
+	}
+
 	//Disable Mesh
-	bIsFree = true;
-	SetComponentTickEnabled(false);
 	//SetRocketVisibility(false);
+
+	if (UFGRocketSubsystem* RocketSubsystem = GetRocketSubsystem())
+	{
+		RocketSubsystem->RemoveRocket(this);
+		RocketSubsystem->ReleaseRocket(this);
+	}
 }
 
 void UFGRocket::SetRocketVisibility(bool bIsVisible)
 {
 	RootComponent->SetVisibility(bIsVisible, true);
 }
+
+UFGRocketSubsystem* UFGRocket::GetRocketSubsystem() const
+{
+	UWorld* World = GetWorld();
+	return World != nullptr ? World->GetSubsystem<UFGRocketSubsystem>() : nullptr;
+}
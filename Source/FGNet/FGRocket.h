@@ -4,8 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "FGRocketFireEvent.h"
 #include "FGRocket.generated.h"
 
+class UFGRocketSubsystem;
 class AFGPlayer;
 
 UCLASS()
@@ -18,11 +20,8 @@ public:
 
 	virtual void BeginPlay() override;
 
-	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-	void StartMoving(const FVector& Forward, const FVector& InStartLocation);
-
-	void ApplyCorrection(const FVector& Forward);
+	//Also used to move a predicted rocket onto the server's path. RewindTime is only used on the server, see UFGRocketSubsystem::AddRocket.
+	void StartMoving(const FFGRocketFireEvent& FireEvent, AFGPlayer* Shooter = nullptr, float RewindTime = 0.0f);
 
 	bool IsFree() const { return bIsFree; }
 
@@ -38,10 +37,13 @@ public:
 	UStaticMeshComponent* MeshComponent = nullptr;
 
 private:
+	friend class UFGRocketSubsystem;
+
 	void SetRocketVisibility(bool bVisible);
 
+	UFGRocketSubsystem* GetRocketSubsystem() const;
+
 private:
-	FCollisionQueryParams CachedCollisionQueryParams;
 
 	UPROPERTY(EditAnywhere, Category = VFX)
 	UParticleSystem* Explosion = nullptr;
@@ -54,19 +56,13 @@ private:
 
 	FVector OriginalFacingDirection = FVector::ZeroVector;
 
-	FVector FacingRotationStart = FVector::ZeroVector;
-
-	FQuat FacingRotationCorrection = FQuat::Identity;
-
-	FVector RocketStartLocation = FVector::ZeroVector;
-
 	float LifeTime = 2.0f;
-	float LifeTimeElapsed = 0.0f;
-
-	float DistanceMoved = 0.0f;
 
 	UPROPERTY(EditAnywhere)
 	float MovementVelocity = 1300.0f;
 
 	bool bIsFree = true;
+
+	//Where this rocket's state is in UFGRocketSubsystem while it flies.
+	int32 SimulationIndex = INDEX_NONE;
 };
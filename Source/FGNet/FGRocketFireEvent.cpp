@@ -0,0 +1,71 @@
+#include "FGRocketFireEvent.h"
+
+void FFGRocketFireEvent::Quantize()
+{
+	const FRotator Rotation = Direction.Rotation();
+	const float Pitch = FFGNetQuantize::DequantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(FFGNetQuantize::QuantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(Rotation.Pitch));
+	const float Yaw = FFGNetQuantize::DequantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(FFGNetQuantize::QuantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(Rotation.Yaw));
+
+	Origin = FFGNetQuantize::QuantizeVector<FGNET_ROCKET_ORIGIN_SCALE>(Origin);
+	Direction = FRotator(Pitch, Yaw, 0.0f).Vector();
+	FireTime = FFGNetQuantize::DequantizeTime(FFGNetQuantize::QuantizeTime(FireTime));
+}
+
+void FFGRocketFireEvent::SerializeBits(FArchive& Ar)
+{
+	const bool bArLoading = Ar.IsLoading();
+
+	Ar << RocketId;
+
+	FVector PackedOrigin = bArLoading ? FVector::ZeroVector : FFGNetQuantize::QuantizeVector<FGNET_ROCKET_ORIGIN_SCALE>(Origin);
+	FFGNetQuantize::SerializeVector<FGNET_ROCKET_ORIGIN_SCALE, FGNET_ROCKET_ORIGIN_MAX_BITS>(PackedOrigin, Ar);
+
+	const FRotator Rotation = bArLoading ? FRotator::ZeroRotator : Direction.Rotation();
+	uint32 PackedPitch = bArLoading ? 0 : FFGNetQuantize::QuantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(Rotation.Pitch);
+	uint32 PackedYaw = bArLoading ? 0 : FFGNetQuantize::QuantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(Rotation.Yaw);
+
+	//Rockets are fired level almost always, a flat one costs a single bit of pitch.
+	uint8 bHasPitch = PackedPitch != 0;
+	Ar.SerializeBits(&bHasPitch, 1);
+
+	if (bHasPitch)
+	{
+		Ar.SerializeBits(&PackedPitch, FGNET_ROCKET_DIRECTION_BITS);
+	}
+
+	Ar.SerializeBits(&PackedYaw, FGNET_ROCKET_DIRECTION_BITS);
+
+	uint32 FireTimeMs = bArLoading ? 0 : FFGNetQuantize::QuantizeTime(FireTime);
+	Ar.SerializeIntPacked(FireTimeMs);
+
+	if (bArLoading)
+	{
+		Origin = PackedOrigin;
+		Direction = FRotator(bHasPitch ? FFGNetQuantize::DequantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(PackedPitch) : 0.0f, FFGNetQuantize::DequantizeAxis<FGNET_ROCKET_DIRECTION_BITS>(PackedYaw), 0.0f).Vector();
+		FireTime = FFGNetQuantize::DequantizeTime(FireTimeMs);
+	}
+}
+
+bool FFGRocketSnapshot::NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	if (Ar.IsSaving() && Rockets.Num() > MaxRockets)
+	{
+		Rockets.SetNum(MaxRockets, false);
+	}
+
+	uint32 NumRockets = Rockets.Num();
+	Ar.SerializeInt(NumRockets, MaxRockets + 1);
+
+	if (Ar.IsLoading())
+	{
+		Rockets.SetNum(NumRockets);
+	}
+
+	for (FFGRocketFireEvent& Rocket : Rockets)
+	{
+		Rocket.SerializeBits(Ar);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Components/Replicator/FGNetQuantize.h"
+#include "FGRocketFireEvent.generated.h"
+
+//Wire precision for rocket fire events, override these from Build.cs (PublicDefinitions) to trade precision for bandwidth.
+
+//Fixed point scale for the origin, 10 = one millimeter.
+#ifndef FGNET_ROCKET_ORIGIN_SCALE
+#define FGNET_ROCKET_ORIGIN_SCALE 10
+#endif
+
+#ifndef FGNET_ROCKET_ORIGIN_MAX_BITS
+#define FGNET_ROCKET_ORIGIN_MAX_BITS 24
+#endif
+
+//Bits for the direction's yaw and pitch each.
+#ifndef FGNET_ROCKET_DIRECTION_BITS
+#define FGNET_ROCKET_DIRECTION_BITS 14
+#endif
+
+//Everything needed to simulate a rocket: it flies in a straight line from Origin along Direction, starting at FireTime.
+USTRUCT()
+struct FFGRocketFireEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	//Only unique per shooter, wraps around long after the rocket it named is gone.
+	uint8 RocketId = 0;
+
+	FVector Origin = FVector::ZeroVector;
+
+	FVector Direction = FVector::ForwardVector;
+
+	//Server world time, see AGameStateBase::GetServerWorldTimeSeconds.
+	float FireTime = 0.0f;
+
+	//Rounds to what the other side receives, so the shooter predicts the same path everyone else simulates.
+	void Quantize();
+
+	void SerializeBits(FArchive& Ar);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+	{
+		SerializeBits(Ar);
+		bOutSuccess = !Ar.IsError();
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGRocketFireEvent> : public TStructOpsTypeTraitsBase2<FFGRocketFireEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//Every rocket in flight, sent once to a player who joins mid fight.
+USTRUCT()
+struct FFGRocketSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+
+	static constexpr int32 MaxRockets = 256;
+
+	UPROPERTY()
+	TArray<FFGRocketFireEvent> Rockets;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGRocketSnapshot> : public TStructOpsTypeTraitsBase2<FFGRocketSnapshot>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
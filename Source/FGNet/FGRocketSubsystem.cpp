@@ -0,0 +1,468 @@
+#include "FGRocketSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "DrawDebugHelpers.h"
+#include "FGRocket.h"
+#include "FGNet/Player/FGPlayer.h"
+#include "FGNet/Debug/FGPredictionBenchmarkSubsystem.h"
+#include "FGNet.h"
+
+void UFGRocketSubsystem::Deinitialize()
+{
+	for (UFGRocket* Rocket : Rockets)
+	{
+		if (Rocket != nullptr)
+		{
+			Rocket->SimulationIndex = INDEX_NONE;
+		}
+	}
+
+	Rockets.Reset();
+	StartLocations.Reset();
+	Positions.Reset();
+	Directions.Reset();
+	RocketIds.Reset();
+	FireTimes.Reset();
+	Distances.Reset();
+	LifeTimes.Reset();
+	Speeds.Reset();
+	Shooters.Reset();
+	RewindTimes.Reset();
+	Players.Reset();
+
+	UE_LOG(LogFGNet, Log, TEXT("%s"), *GetPoolReport());
+
+	for (TPair<UClass*, FFGRocketPool>& Pair : Pools)
+	{
+		for (UFGRocket* Rocket : Pair.Value.AllRockets)
+		{
+			if (Rocket != nullptr)
+			{
+				Rocket->DestroyComponent();
+			}
+		}
+	}
+
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGRocketSubsystem::Tick(float DeltaTime)
+{
+	if (bIsPrewarming)
+	{
+		TickPrewarm();
+	}
+
+	const int32 NumRockets = Rockets.Num();
+
+	//Movement, plain data only. Rockets fly straight, so this is the same path on every machine.
+	for (int32 Index = 0; Index < NumRockets; Index++)
+	{
+		LifeTimes[Index] -= DeltaTime;
+		Distances[Index] += Speeds[Index] * DeltaTime;
+		Positions[Index] = StartLocations[Index] + Directions[Index] * Distances[Index];
+	}
+
+	//Collision, the rockets themselves have no collision so one set of query params does for all of them.
+	//The server tests players separately at the time the shooter saw them, the world trace ignores them.
+	UWorld* World = GetWorld();
+	const bool bIsServer = World->GetNetMode() < NM_Client;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FGRocketTrace));
+	ExplodedRockets.Reset();
+
+	if (bIsServer)
+	{
+		for (AFGPlayer* Player : Players)
+		{
+			QueryParams.AddIgnoredActor(Player);
+		}
+	}
+
+	//Clients benchmarking prediction check their own rockets against the other players as they draw them.
+	UFGPredictionBenchmarkSubsystem* Benchmark = !bIsServer && World->GetGameInstance() != nullptr ? World->GetGameInstance()->GetSubsystem<UFGPredictionBenchmarkSubsystem>() : nullptr;
+
+	if (Benchmark != nullptr && !Benchmark->IsRecording())
+	{
+		Benchmark = nullptr;
+	}
+
+	for (int32 Index = 0; Index < NumRockets; Index++)
+	{
+		if (LifeTimes[Index] < 0.0f)
+		{
+			ExplodedRockets.Add(Index);
+			continue;
+		}
+
+		FHitResult Hit;
+		const FVector EndLocation = Positions[Index] + Directions[Index] * 100.0f;
+		const bool bWorldHit = World->LineTraceSingleByChannel(Hit, Positions[Index], EndLocation, ECC_Visibility, QueryParams);
+
+		if (bIsServer)
+		{
+			float PlayerHitDistance = 0.0f;
+			AFGPlayer* HitPlayer = FindLagCompensatedHit(Index, EndLocation, PlayerHitDistance);
+
+			if (HitPlayer != nullptr && (!bWorldHit || PlayerHitDistance <= Hit.Distance))
+			{
+				HitPlayer->OnHit(Rockets[Index]->DamageAmount, RocketIds[Index]);
+				ExplodedRockets.Add(Index);
+				continue;
+			}
+		}
+
+		if (Benchmark != nullptr)
+		{
+			Benchmark->TestViewHit(Shooters[Index], RocketIds[Index], Positions[Index], EndLocation);
+		}
+
+		//Clients only explode, damage is the server's call.
+		if (bWorldHit)
+		{
+			ExplodedRockets.Add(Index);
+		}
+	}
+
+	//Transforms, in one pass after all the queries.
+	for (int32 Index = 0; Index < NumRockets; Index++)
+	{
+		Rockets[Index]->SetWorldLocation(Positions[Index]);
+
+#if !UE_BUILD_SHIPPING
+
+		if (Rockets[Index]->bDebugDrawCorrection)
+		{
+			const float ArrowLength = 3000.0f;
+			const float ArrowSize = 50.0f;
+			const FVector& StartLocation = StartLocations[Index];
+
+			DrawDebugDirectionalArrow(World, StartLocation, StartLocation + Rockets[Index]->OriginalFacingDirection * ArrowLength, ArrowSize, FColor::Red);
+			DrawDebugDirectionalArrow(World, StartLocation, StartLocation + Directions[Index] * ArrowLength, ArrowSize, FColor::Green);
+		}
+
+#endif // !UE_BUILD_SHIPPING
+	}
+
+	//Back to front, exploding removes the rocket with a swap.
+	for (int32 Index = ExplodedRockets.Num() - 1; Index >= 0; Index--)
+	{
+		Rockets[ExplodedRockets[Index]]->Explode();
+	}
+}
+
+bool UFGRocketSubsystem::IsTickable() const
+{
+	return (Rockets.Num() > 0 || bIsPrewarming) && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UFGRocketSubsystem::GetStatId() const
+{
+	return UObject::GetStatID();
+}
+
+void UFGRocketSubsystem::AddRocket(UFGRocket* Rocket, const FFGRocketFireEvent& FireEvent, AFGPlayer* Shooter, float RewindTime)
+{
+	if (!ensure(Rocket != nullptr))
+	{
+		return;
+	}
+
+	int32 Index = Rocket->SimulationIndex;
+
+	if (Index == INDEX_NONE)
+	{
+		Index = Rockets.Add(Rocket);
+		StartLocations.AddUninitialized();
+		Positions.AddUninitialized();
+		Directions.AddUninitialized();
+		RocketIds.AddUninitialized();
+		FireTimes.AddUninitialized();
+		Distances.AddUninitialized();
+		LifeTimes.AddUninitialized();
+		Speeds.AddUninitialized();
+		Shooters.AddUninitialized();
+		RewindTimes.AddUninitialized();
+		Rocket->SimulationIndex = Index;
+	}
+
+	//Fast forward by however long ago it was fired, that is where it is on the server too.
+	const float FlightTime = FMath::Clamp(GetServerWorldTime() - FireEvent.FireTime, 0.0f, Rocket->LifeTime);
+
+	StartLocations[Index] = FireEvent.Origin;
+	Directions[Index] = FireEvent.Direction;
+	RocketIds[Index] = FireEvent.RocketId;
+	FireTimes[Index] = FireEvent.FireTime;
+	Speeds[Index] = Rocket->MovementVelocity;
+	Distances[Index] = Speeds[Index] * FlightTime;
+	LifeTimes[Index] = Rocket->LifeTime - FlightTime;
+	Positions[Index] = FireEvent.Origin + FireEvent.Direction * Distances[Index];
+	Shooters[Index] = Shooter;
+	RewindTimes[Index] = FMath::Clamp(RewindTime, 0.0f, MaxLagCompensationTime);
+}
+
+void UFGRocketSubsystem::RemoveRocket(UFGRocket* Rocket)
+{
+	if (Rocket != nullptr && Rockets.IsValidIndex(Rocket->SimulationIndex))
+	{
+		RemoveAtSwap(Rocket->SimulationIndex);
+		Rocket->SimulationIndex = INDEX_NONE;
+	}
+}
+
+UFGRocket* UFGRocketSubsystem::FindRocket(const AFGPlayer* Shooter, uint8 RocketId) const
+{
+	for (int32 Index = 0; Index < Rockets.Num(); Index++)
+	{
+		if (RocketIds[Index] == RocketId && Shooters[Index] == Shooter)
+		{
+			return Rockets[Index];
+		}
+	}
+
+	return nullptr;
+}
+
+void UFGRocketSubsystem::GetFireEvents(TArray<FFGRocketFireEvent>& OutFireEvents) const
+{
+	OutFireEvents.Reset(Rockets.Num());
+
+	for (int32 Index = 0; Index < Rockets.Num(); Index++)
+	{
+		FFGRocketFireEvent& FireEvent = OutFireEvents.AddDefaulted_GetRef();
+		FireEvent.RocketId = RocketIds[Index];
+		FireEvent.Origin = StartLocations[Index];
+		FireEvent.Direction = Directions[Index];
+		FireEvent.FireTime = FireTimes[Index];
+	}
+}
+
+float UFGRocketSubsystem::GetServerWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World != nullptr ? World->GetGameState() : nullptr;
+
+	if (GameState == nullptr)
+	{
+		return World != nullptr ? World->GetTimeSeconds() : 0.0f;
+	}
+
+	float ServerWorldTime = GameState->GetServerWorldTimeSeconds();
+
+	//The replicated server time is already a one way trip old when it arrives, without this clients fire into the past.
+	if (World->GetNetMode() == NM_Client)
+	{
+		const APlayerController* PlayerController = World->GetFirstPlayerController();
+		const APlayerState* PlayerState = PlayerController != nullptr ? PlayerController->PlayerState : nullptr;
+
+		if (PlayerState != nullptr)
+		{
+			//ExactPing is the round trip in milliseconds.
+			ServerWorldTime += PlayerState->ExactPing * 0.0005f;
+		}
+	}
+
+	return ServerWorldTime;
+}
+
+bool UFGRocketSubsystem::MarkRocketSnapshotSent(const UNetConnection* Connection)
+{
+	if (Connection == nullptr)
+	{
+		return false;
+	}
+
+	for (auto It = RocketSnapshotConnections.CreateIterator(); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	bool bIsAlreadyInSet = false;
+	RocketSnapshotConnections.Add(Connection, &bIsAlreadyInSet);
+	return !bIsAlreadyInSet;
+}
+
+void UFGRocketSubsystem::RemoveAtSwap(int32 Index)
+{
+	Rockets.RemoveAtSwap(Index, 1, false);
+	StartLocations.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Directions.RemoveAtSwap(Index, 1, false);
+	RocketIds.RemoveAtSwap(Index, 1, false);
+	FireTimes.RemoveAtSwap(Index, 1, false);
+	Distances.RemoveAtSwap(Index, 1, false);
+	LifeTimes.RemoveAtSwap(Index, 1, false);
+	Speeds.RemoveAtSwap(Index, 1, false);
+	Shooters.RemoveAtSwap(Index, 1, false);
+	RewindTimes.RemoveAtSwap(Index, 1, false);
+
+	if (Rockets.IsValidIndex(Index))
+	{
+		Rockets[Index]->SimulationIndex = Index;
+	}
+}
+
+void UFGRocketSubsystem::PrewarmRockets(TSubclassOf<UFGRocket> RocketClass, int32 NumRockets)
+{
+	if (RocketClass == nullptr || NumRockets <= 0)
+	{
+		return;
+	}
+
+	FFGRocketPool& Pool = Pools.FindOrAdd(RocketClass);
+	Pool.PrewarmTarget = FMath::Min(FMath::Max(Pool.PrewarmTarget, Pool.AllRockets.Num()) + NumRockets, MaxPooledRockets);
+	bIsPrewarming |= Pool.AllRockets.Num() < Pool.PrewarmTarget;
+}
+
+UFGRocket* UFGRocketSubsystem::AcquireRocket(TSubclassOf<UFGRocket> RocketClass)
+{
+	if (RocketClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FFGRocketPool& Pool = Pools.FindOrAdd(RocketClass);
+	UFGRocket* Rocket = nullptr;
+
+	if (Pool.FreeRockets.Num() > 0)
+	{
+		Rocket = Pool.FreeRockets.Pop(false);
+	}
+
+	else if (Pool.AllRockets.Num() < MaxPooledRockets)
+	{
+		Rocket = CreateRocket(RocketClass, Pool);
+	}
+
+	if (Rocket == nullptr)
+	{
+		return nullptr;
+	}
+
+	Rocket->bIsFree = false;
+	Pool.NumInUse++;
+	Pool.PeakInUse = FMath::Max(Pool.PeakInUse, Pool.NumInUse);
+	return Rocket;
+}
+
+void UFGRocketSubsystem::ReleaseRocket(UFGRocket* Rocket)
+{
+	FFGRocketPool* Pool = Rocket != nullptr ? Pools.Find(Rocket->GetClass()) : nullptr;
+
+	if (Pool == nullptr)
+	{
+		return;
+	}
+
+	Rocket->bIsFree = true;
+	Pool->FreeRockets.Add(Rocket);
+	Pool->NumInUse--;
+}
+
+FString UFGRocketSubsystem::GetPoolReport() const
+{
+	FString Report;
+
+	for (const TPair<UClass*, FFGRocketPool>& Pair : Pools)
+	{
+		const FFGRocketPool& Pool = Pair.Value;
+
+		Report += FString::Printf(TEXT("%s: %d created, %d in use, %d free, peak %d in use, max %d\n"),
+			*GetNameSafe(Pair.Key),
+			Pool.AllRockets.Num(),
+			Pool.NumInUse,
+			Pool.FreeRockets.Num(),
+			Pool.PeakInUse,
+			MaxPooledRockets);
+	}
+
+	return Report.Len() > 0 ? Report : TEXT("No rocket pools");
+}
+
+void UFGRocketSubsystem::RegisterPlayer(AFGPlayer* Player)
+{
+	Players.AddUnique(Player);
+}
+
+void UFGRocketSubsystem::UnregisterPlayer(AFGPlayer* Player)
+{
+	Players.RemoveSingleSwap(Player, false);
+
+	for (int32 Index = 0; Index < Shooters.Num(); Index++)
+	{
+		if (Shooters[Index] == Player)
+		{
+			Shooters[Index] = nullptr;
+		}
+	}
+}
+
+AFGPlayer* UFGRocketSubsystem::FindLagCompensatedHit(int32 Index, const FVector& EndLocation, float& OutHitDistance) const
+{
+	const FVector& StartLocation = Positions[Index];
+	const float HitTime = GetWorld()->GetTimeSeconds() - RewindTimes[Index];
+	AFGPlayer* HitPlayer = nullptr;
+
+	for (AFGPlayer* Player : Players)
+	{
+		FVector PlayerLocation;
+
+		if (Player == nullptr || Player == Shooters[Index] || !Player->GetTransformHistory().Sample(HitTime, PlayerLocation))
+		{
+			continue;
+		}
+
+		const FVector ClosestPoint = FMath::ClosestPointOnSegment(PlayerLocation, StartLocation, EndLocation);
+
+		if (FVector::DistSquared(ClosestPoint, PlayerLocation) > FMath::Square(Player->GetCollisionRadius()))
+		{
+			continue;
+		}
+
+		const float HitDistance = FVector::Distance(StartLocation, ClosestPoint);
+
+		if (HitPlayer == nullptr || HitDistance < OutHitDistance)
+		{
+			HitPlayer = Player;
+			OutHitDistance = HitDistance;
+		}
+	}
+
+	return HitPlayer;
+}
+
+UFGRocket* UFGRocketSubsystem::CreateRocket(UClass* RocketClass, FFGRocketPool& Pool)
+{
+	UFGRocket* Rocket = NewObject<UFGRocket>(this, RocketClass);
+	Rocket->SetAbsolute(true);
+	Rocket->RegisterComponentWithWorld(GetWorld());
+
+	Pool.AllRockets.Add(Rocket);
+	return Rocket;
+}
+
+void UFGRocketSubsystem::TickPrewarm()
+{
+	int32 NumToCreate = RocketsCreatedPerFrame;
+	bIsPrewarming = false;
+
+	for (TPair<UClass*, FFGRocketPool>& Pair : Pools)
+	{
+		FFGRocketPool& Pool = Pair.Value;
+
+		while (NumToCreate > 0 && Pool.AllRockets.Num() < Pool.PrewarmTarget)
+		{
+			Pool.FreeRockets.Add(CreateRocket(Pair.Key, Pool));
+			NumToCreate--;
+		}
+
+		bIsPrewarming |= Pool.AllRockets.Num() < Pool.PrewarmTarget;
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FGRocketFireEvent.h"
+#include "FGRocketSubsystem.generated.h"
+
+class UFGRocket;
+class AFGPlayer;
+class UNetConnection;
+
+//Rockets of one class, created once and reused for the lifetime of the world.
+USTRUCT()
+struct FFGRocketPool
+{
+	GENERATED_BODY()
+
+	//Every rocket this pool created, in use or not.
+	UPROPERTY(Transient)
+	TArray<UFGRocket*> AllRockets;
+
+	UPROPERTY(Transient)
+	TArray<UFGRocket*> FreeRockets;
+
+	//How many rockets the pool should have created once the prewarm is done.
+	int32 PrewarmTarget = 0;
+
+	int32 NumInUse = 0;
+
+	int32 PeakInUse = 0;
+};
+
+//Simulates every rocket in flight in one place. State lives in parallel arrays so the update is a tight loop
+//over plain data, the components are only touched to push their final transforms.
+//Also owns the world's rocket pool, so rockets are shared between players instead of cached per player.
+UCLASS(Config = Game)
+class FGNET_API UFGRocketSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameobject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	//FTickableGameObject
+
+	//The rocket starts where the event says it is by now. Adding a rocket that is already flying moves it onto the new path.
+	//RewindTime is how far in the past the shooter saw the other players, the server tests hits against them as they were then.
+	void AddRocket(UFGRocket* Rocket, const FFGRocketFireEvent& FireEvent, AFGPlayer* Shooter, float RewindTime);
+
+	void RemoveRocket(UFGRocket* Rocket);
+
+	UFGRocket* FindRocket(const AFGPlayer* Shooter, uint8 RocketId) const;
+
+	//Fire events of every rocket in flight, for players who join late.
+	void GetFireEvents(TArray<FFGRocketFireEvent>& OutFireEvents) const;
+
+	//The clock fire events are in, server world time estimated on clients.
+	float GetServerWorldTime() const;
+
+	//Returns true the first time it is called for a connection, the rocket snapshot is only sent once per connection.
+	bool MarkRocketSnapshotSent(const UNetConnection* Connection);
+
+	int32 GetNumRockets() const { return Rockets.Num(); }
+
+	//Creates rockets over the next frames until the pool has NumRockets more, up to MaxPooledRockets.
+	void PrewarmRockets(TSubclassOf<UFGRocket> RocketClass, int32 NumRockets);
+
+	//Returns nullptr when the pool is at MaxPooledRockets and all of them are in use.
+	UFGRocket* AcquireRocket(TSubclassOf<UFGRocket> RocketClass);
+
+	void ReleaseRocket(UFGRocket* Rocket);
+
+	FString GetPoolReport() const;
+
+	//Players rockets can hit on the server, tested against their transform history instead of their current collision.
+	void RegisterPlayer(AFGPlayer* Player);
+
+	void UnregisterPlayer(AFGPlayer* Player);
+
+	//Hard limit on rockets per class, the pool grows on demand up to this.
+	UPROPERTY(Config)
+	int32 MaxPooledRockets = 256;
+
+	//Rockets created per frame while prewarming.
+	UPROPERTY(Config)
+	int32 RocketsCreatedPerFrame = 4;
+
+	//How many rockets the pool is prewarmed with for each player that joins.
+	UPROPERTY(Config)
+	int32 RocketsPrewarmedPerPlayer = 4;
+
+	//Longest a hit may be rewound on the server, players with worse ping have to lead their shots.
+	UPROPERTY(Config)
+	float MaxLagCompensationTime = 0.25f;
+
+private:
+
+	//Adds the rocket to the pool but not to its free list, that is up to the caller.
+	UFGRocket* CreateRocket(UClass* RocketClass, FFGRocketPool& Pool);
+
+	void TickPrewarm();
+
+	//Server only, returns the player the rocket's path crosses at the rewound time, or nullptr.
+	AFGPlayer* FindLagCompensatedHit(int32 Index, const FVector& EndLocation, float& OutHitDistance) const;
+
+	//Swaps the last rocket into Index, order does not matter.
+	void RemoveAtSwap(int32 Index);
+
+	UPROPERTY(Transient)
+	TArray<UFGRocket*> Rockets;
+
+	TArray<FVector> StartLocations;
+
+	TArray<FVector> Positions;
+
+	TArray<FVector> Directions;
+
+	TArray<uint8> RocketIds;
+
+	TArray<float> FireTimes;
+
+	TArray<float> Distances;
+
+	//Remaining lifetime.
+	TArray<float> LifeTimes;
+
+	TArray<float> Speeds;
+
+	UPROPERTY(Transient)
+	TArray<AFGPlayer*> Shooters;
+
+	TArray<float> RewindTimes;
+
+	UPROPERTY(Transient)
+	TArray<AFGPlayer*> Players;
+
+	//Reused every tick, indices of rockets that hit something.
+	TArray<int32> ExplodedRockets;
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FFGRocketPool> Pools;
+
+	//Connections that already got the rocket snapshot, a respawn does not need another one.
+	TSet<TWeakObjectPtr<const UNetConnection>> RocketSnapshotConnections;
+
+	bool bIsPrewarming = false;
+};
@@ -0,0 +1,163 @@
+#include "FGMoveQueue.h"
+
+void FFGClientMoveQueue::AddMove(const FGMovementData& Move, int32 MaxMovesPerPacket)
+{
+	const int32 NumUnsentMoves = Moves.Num() - NumSentMoves;
+
+	//Same input as the previous unsent move, the server simulates the span of both the same way as one move.
+	if (NumUnsentMoves > 0 && Moves.Last().HasSameInput(Move))
+	{
+		Moves.Last() = Move;
+		return;
+	}
+
+	if (Moves.Num() >= MaxUnackedMoves)
+	{
+		Moves.RemoveAt(0, 1, false);
+		NumSentMoves = FMath::Max(NumSentMoves - 1, 0);
+	}
+
+	Moves.Add(Move);
+	bIsPacketFull = Moves.Num() - NumSentMoves >= MaxMovesPerPacket;
+}
+
+bool FFGClientMoveQueue::TickSend(float DeltaTime, int32 SendRate)
+{
+	const float SendInterval = 1.0f / static_cast<float>(FMath::Max(SendRate, 1));
+	SendTimer += DeltaTime;
+
+	if (NumSentMoves >= Moves.Num())
+	{
+		return false;
+	}
+
+	//A full packet goes out early, merging moves with different input would make the server simulate the wrong input.
+	if (bIsPacketFull)
+	{
+		SendTimer = 0.0f;
+		return true;
+	}
+
+	if (SendTimer < SendInterval)
+	{
+		return false;
+	}
+
+	//Never more than one packet per frame, even after a hitch.
+	SendTimer = FMath::Fmod(SendTimer, SendInterval);
+	return true;
+}
+
+void FFGClientMoveQueue::BuildPacket(FFGClientMovePacket& OutPacket, int32 NumRedundantMoves, float SendTime)
+{
+	const int32 FirstMove = FMath::Max(NumSentMoves - NumRedundantMoves, 0);
+
+	OutPacket.Moves.Reset(Moves.Num() - FirstMove);
+
+	for (int32 Index = FirstMove; Index < Moves.Num(); Index++)
+	{
+		OutPacket.Moves.Add(Moves[Index]);
+	}
+
+	NumSentMoves = Moves.Num();
+	bIsPacketFull = false;
+
+	if (SentPackets.Num() >= MaxSentPackets)
+	{
+		SentPackets.RemoveAt(0, 1, false);
+	}
+
+	FSentPacket& SentPacket = SentPackets.AddDefaulted_GetRef();
+	SentPacket.NewestTimeStamp = Moves.Last().TimeStamp;
+	SentPacket.SendTime = SendTime;
+}
+
+bool FFGClientMoveQueue::FindSendTime(float AckedTimeStamp, float& OutSendTime) const
+{
+	for (const FSentPacket& SentPacket : SentPackets)
+	{
+		if (SentPacket.NewestTimeStamp == AckedTimeStamp)
+		{
+			OutSendTime = SentPacket.SendTime;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FFGClientMoveQueue::AckMoves(float AckedTimeStamp)
+{
+	int32 NumAcked = 0;
+
+	while (NumAcked < NumSentMoves && Moves[NumAcked].TimeStamp <= AckedTimeStamp)
+	{
+		NumAcked++;
+	}
+
+	if (NumAcked > 0)
+	{
+		Moves.RemoveAt(0, NumAcked, false);
+		NumSentMoves -= NumAcked;
+	}
+
+	int32 NumAckedPackets = 0;
+
+	while (NumAckedPackets < SentPackets.Num() && SentPackets[NumAckedPackets].NewestTimeStamp <= AckedTimeStamp)
+	{
+		NumAckedPackets++;
+	}
+
+	SentPackets.RemoveAt(0, NumAckedPackets, false);
+}
+
+void FFGClientMoveQueue::Reset()
+{
+	Moves.Reset();
+	NumSentMoves = 0;
+	bIsPacketFull = false;
+	SentPackets.Reset();
+	SendTimer = 0.0f;
+}
+
+FFGPredictedMoveBuffer::FFGPredictedMoveBuffer()
+{
+	Moves.SetNum(Capacity);
+}
+
+void FFGPredictedMoveBuffer::Add(const FFGPredictedMove& Move)
+{
+	if (Count == Capacity)
+	{
+		Head = (Head + 1) % Capacity;
+		Count--;
+	}
+
+	Moves[(Head + Count) % Capacity] = Move;
+	Count++;
+}
+
+bool FFGPredictedMoveBuffer::PopUntil(float TimeStamp, FFGPredictedMove& OutAckedMove)
+{
+	bool bFound = false;
+
+	while (Count > 0 && Moves[Head].Move.TimeStamp <= TimeStamp)
+	{
+		if (Moves[Head].Move.TimeStamp == TimeStamp)
+		{
+			OutAckedMove = Moves[Head];
+			bFound = true;
+		}
+
+		Head = (Head + 1) % Capacity;
+		Count--;
+	}
+
+	return bFound;
+}
+
+void FFGPredictedMoveBuffer::Reset()
+{
+	Head = 0;
+	Count = 0;
+}
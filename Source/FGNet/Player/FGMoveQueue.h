@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FGMovementData.h"
+
+//Client side buffer of moves the server has not acknowledged yet, sent at a fixed rate instead of every frame.
+class FGNET_API FFGClientMoveQueue
+{
+public:
+
+	//Never drops input, a packet that reaches MaxMovesPerPacket new moves is sent without waiting for the rate.
+	void AddMove(const FGMovementData& Move, int32 MaxMovesPerPacket);
+
+	//Returns true when it is time to send a packet at the given rate, or right away when the packet is full.
+	bool TickSend(float DeltaTime, int32 SendRate);
+
+	//SendTime is remembered for the packet, see FindSendTime.
+	void BuildPacket(FFGClientMovePacket& OutPacket, int32 NumRedundantMoves, float SendTime);
+
+	//The server acks the newest move of the packet it got, so an ack finds when the packet it answers was sent.
+	//Call before AckMoves, which forgets the packets the ack covers.
+	bool FindSendTime(float AckedTimeStamp, float& OutSendTime) const;
+
+	void AckMoves(float AckedTimeStamp);
+
+	void Reset();
+
+	int32 GetNumUnackedMoves() const { return Moves.Num(); }
+
+private:
+
+	struct FSentPacket
+	{
+		float NewestTimeStamp = 0.0f;
+
+		float SendTime = 0.0f;
+	};
+
+	//If the server stops acking we don't want to grow forever.
+	static constexpr int32 MaxUnackedMoves = 64;
+
+	static constexpr int32 MaxSentPackets = 32;
+
+	//Oldest first, everything before NumSentMoves has been sent at least once.
+	TArray<FGMovementData> Moves;
+
+	int32 NumSentMoves = 0;
+
+	bool bIsPacketFull = false;
+
+	//Oldest first, packets that were not acked yet.
+	TArray<FSentPacket, TInlineAllocator<MaxSentPackets>> SentPackets;
+
+	float SendTimer = 0.0f;
+};
+
+//A move the client simulated locally and the state it ended up in, kept until the server acks it.
+struct FFGPredictedMove
+{
+	FGMovementData Move;
+
+	float DeltaTime = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+
+	float Velocity = 0.0f;
+
+	float Yaw = 0.0f;
+
+	float Gravity = 0.0f;
+};
+
+//Fixed size ring of predicted moves, oldest first. When full the oldest move is overwritten.
+class FGNET_API FFGPredictedMoveBuffer
+{
+public:
+
+	FFGPredictedMoveBuffer();
+
+	void Add(const FFGPredictedMove& Move);
+
+	//Drops every move up to and including TimeStamp, returns true and the move if one matched TimeStamp exactly.
+	bool PopUntil(float TimeStamp, FFGPredictedMove& OutAckedMove);
+
+	void Reset();
+
+	int32 Num() const { return Count; }
+
+	FFGPredictedMove& operator[](int32 Index) { return Moves[(Head + Index) % Capacity]; }
+
+private:
+
+	static constexpr int32 Capacity = 128;
+
+	TArray<FFGPredictedMove> Moves;
+
+	int32 Head = 0;
+
+	int32 Count = 0;
+};
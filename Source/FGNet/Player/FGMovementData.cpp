@@ -0,0 +1,255 @@
+#include "FGMovementData.h"
+#include "Serialization/BitWriter.h"
+
+namespace
+{
+	constexpr int32 MaxInputStep = (1 << (FGNET_MOVE_INPUT_BITS - 1)) - 1;
+
+	uint32 QuantizeInput(float Value)
+	{
+		return static_cast<uint32>(FMath::RoundToInt(FMath::Clamp(Value, -1.0f, 1.0f) * MaxInputStep) + MaxInputStep);
+	}
+
+	float DequantizeInput(uint32 Value)
+	{
+		return static_cast<float>(static_cast<int32>(Value) - MaxInputStep) / static_cast<float>(MaxInputStep);
+	}
+
+	int64 GetNumBits(const FBitWriter* BudgetWriter)
+	{
+		return BudgetWriter != nullptr ? BudgetWriter->GetNumBits() : 0;
+	}
+}
+
+FString FFGMoveBitBudget::ToString() const
+{
+	const float Moves = static_cast<float>(FMath::Max(NumMoves, 1));
+
+	return FString::Printf(TEXT("%d moves, bits per move: Location %.1f, TimeStamp %.1f, Input %.1f, Brake %.1f, Yaw %.1f, Header %.1f = %.1f bits (%.1f bytes), unpacked %d bits"),
+		NumMoves,
+		LocationBits / Moves,
+		TimeStampBits / Moves,
+		InputBits / Moves,
+		BrakeBits / Moves,
+		YawBits / Moves,
+		HeaderBits / Moves,
+		GetTotalBits() / Moves,
+		GetTotalBits() / Moves / 8.0f,
+		FGMovementData::UnpackedMoveBits);
+}
+
+void FGMovementData::Quantize()
+{
+	Location = FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Location);
+	TimeStamp = FFGNetQuantize::DequantizeTime(FFGNetQuantize::QuantizeTime(TimeStamp));
+	Forward = DequantizeInput(QuantizeInput(Forward));
+	Turn = DequantizeInput(QuantizeInput(Turn));
+	Yaw = FFGNetQuantize::DequantizeAxis<FGNET_MOVE_YAW_BITS>(FFGNetQuantize::QuantizeAxis<FGNET_MOVE_YAW_BITS>(Yaw));
+}
+
+void FGMovementData::SerializeBits(FArchive& Ar, const FGMovementData* PreviousMove)
+{
+	SerializeBits(Ar, PreviousMove, nullptr, nullptr);
+}
+
+void FGMovementData::SerializeBits(FBitWriter& Writer, const FGMovementData* PreviousMove, FFGMoveBitBudget& Budget)
+{
+	SerializeBits(Writer, PreviousMove, &Writer, &Budget);
+}
+
+void FGMovementData::SerializeBits(FArchive& Ar, const FGMovementData* PreviousMove, const FBitWriter* BudgetWriter, FFGMoveBitBudget* Budget)
+{
+	const bool bArLoading = Ar.IsLoading();
+	int64 Mark = GetNumBits(BudgetWriter);
+
+	auto Account = [BudgetWriter, Budget, &Mark](int64 FFGMoveBitBudget::* Field)
+	{
+		if (Budget != nullptr)
+		{
+			const int64 NumBits = GetNumBits(BudgetWriter);
+			Budget->*Field += NumBits - Mark;
+			Mark = NumBits;
+		}
+	};
+
+	//Location, on the fixed point grid so deltas between moves are exact.
+	{
+		const bool bRelative = FGNET_MOVE_RELATIVE_LOCATION && PreviousMove != nullptr;
+		FVector Value = bArLoading ? FVector::ZeroVector : (bRelative ? FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Location) - FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(PreviousMove->Location) : FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Location));
+
+		FFGNetQuantize::SerializeVector<FGNET_MOVE_LOCATION_SCALE, FGNET_MOVE_LOCATION_MAX_BITS>(Value, Ar);
+
+		if (bArLoading)
+		{
+			Location = FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(bRelative ? PreviousMove->Location + Value : Value);
+		}
+
+		Account(&FFGMoveBitBudget::LocationBits);
+	}
+
+	//TimeStamp in whole milliseconds, a short delta when it follows another move.
+	{
+		uint32 TimeMs = bArLoading ? 0 : FFGNetQuantize::QuantizeTime(TimeStamp);
+		uint8 bIsDelta = 0;
+
+		if (PreviousMove != nullptr)
+		{
+			const uint32 PreviousTimeMs = FFGNetQuantize::QuantizeTime(PreviousMove->TimeStamp);
+
+			if (!bArLoading)
+			{
+				bIsDelta = TimeMs >= PreviousTimeMs && (TimeMs - PreviousTimeMs) < (1u << FGNET_MOVE_TIME_DELTA_BITS);
+			}
+
+			Ar.SerializeBits(&bIsDelta, 1);
+
+			if (bIsDelta)
+			{
+				uint32 DeltaMs = TimeMs - PreviousTimeMs;
+				Ar.SerializeBits(&DeltaMs, FGNET_MOVE_TIME_DELTA_BITS);
+				TimeMs = PreviousTimeMs + DeltaMs;
+			}
+		}
+
+		if (!bIsDelta)
+		{
+			Ar.SerializeIntPacked(TimeMs);
+		}
+
+		if (bArLoading)
+		{
+			TimeStamp = FFGNetQuantize::DequantizeTime(TimeMs);
+		}
+
+		Account(&FFGMoveBitBudget::TimeStampBits);
+	}
+
+	//Input axes.
+	{
+		uint32 PackedForward = bArLoading ? 0 : QuantizeInput(Forward);
+		uint32 PackedTurn = bArLoading ? 0 : QuantizeInput(Turn);
+		Ar.SerializeBits(&PackedForward, FGNET_MOVE_INPUT_BITS);
+		Ar.SerializeBits(&PackedTurn, FGNET_MOVE_INPUT_BITS);
+
+		if (bArLoading)
+		{
+			Forward = DequantizeInput(PackedForward);
+			Turn = DequantizeInput(PackedTurn);
+		}
+
+		Account(&FFGMoveBitBudget::InputBits);
+	}
+
+	{
+		uint8 BrakeBit = bBrake;
+		Ar.SerializeBits(&BrakeBit, 1);
+		bBrake = BrakeBit != 0;
+
+		Account(&FFGMoveBitBudget::BrakeBits);
+	}
+
+	{
+		uint32 PackedYaw = bArLoading ? 0 : FFGNetQuantize::QuantizeAxis<FGNET_MOVE_YAW_BITS>(Yaw);
+		Ar.SerializeBits(&PackedYaw, FGNET_MOVE_YAW_BITS);
+
+		if (bArLoading)
+		{
+			Yaw = FFGNetQuantize::DequantizeAxis<FGNET_MOVE_YAW_BITS>(PackedYaw);
+		}
+
+		Account(&FFGMoveBitBudget::YawBits);
+	}
+}
+
+FGMovementData FGMovementData::MakeDelta(const FGMovementData& Baseline) const
+{
+	FGMovementData Delta = *this;
+	Delta.Location = FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Location) - FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Baseline.Location);
+	Delta.TimeStamp = FFGNetQuantize::DequantizeTime(FFGNetQuantize::QuantizeTime(TimeStamp) - FFGNetQuantize::QuantizeTime(Baseline.TimeStamp));
+	return Delta;
+}
+
+FGMovementData FGMovementData::ApplyDelta(const FGMovementData& Baseline) const
+{
+	FGMovementData Move = *this;
+	Move.Location = FFGNetQuantize::QuantizeVector<FGNET_MOVE_LOCATION_SCALE>(Baseline.Location + Location);
+	Move.TimeStamp = FFGNetQuantize::DequantizeTime(FFGNetQuantize::QuantizeTime(Baseline.TimeStamp) + FFGNetQuantize::QuantizeTime(TimeStamp));
+	return Move;
+}
+
+void FGMovementData::MeasureBitBudget(const TArray<FGMovementData>& Moves, FFGMoveBitBudget& OutBudget)
+{
+	FBitWriter Writer(0, true);
+
+	uint32 NumMoves = FMath::Min(Moves.Num(), FFGClientMovePacket::MaxMoves);
+	Writer.SerializeInt(NumMoves, FFGClientMovePacket::MaxMoves + 1);
+	OutBudget.HeaderBits += Writer.GetNumBits();
+
+	for (uint32 Index = 0; Index < NumMoves; Index++)
+	{
+		FGMovementData Move = Moves[Index];
+		Move.SerializeBits(Writer, Index > 0 ? &Moves[Index - 1] : nullptr, OutBudget);
+		OutBudget.NumMoves++;
+	}
+}
+
+bool FFGClientMovePacket::NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	//Keep the newest moves if we somehow have more than fits.
+	if (Ar.IsSaving() && Moves.Num() > MaxMoves)
+	{
+		Moves.RemoveAt(0, Moves.Num() - MaxMoves, false);
+	}
+
+	uint32 NumMoves = Moves.Num();
+	Ar.SerializeInt(NumMoves, MaxMoves + 1);
+
+	if (Ar.IsLoading())
+	{
+		Moves.SetNum(NumMoves);
+	}
+
+	for (int32 Index = 0; Index < Moves.Num(); Index++)
+	{
+		Moves[Index].SerializeBits(Ar, Index > 0 ? &Moves[Index - 1] : nullptr);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FFGMovementHistory::Add(uint8 Sequence, const FGMovementData& Move)
+{
+	const int32 Slot = Sequence % Capacity;
+	Moves[Slot] = Move;
+	Sequences[Slot] = Sequence;
+	bIsValid[Slot] = true;
+}
+
+const FGMovementData* FFGMovementHistory::Find(uint8 Sequence) const
+{
+	const int32 Slot = Sequence % Capacity;
+	return bIsValid[Slot] && Sequences[Slot] == Sequence ? &Moves[Slot] : nullptr;
+}
+
+bool FFGMovementUpdate::NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	Ar.SerializeBits(&Sequence, 8);
+
+	uint8 DeltaBit = bIsDelta;
+	Ar.SerializeBits(&DeltaBit, 1);
+	bIsDelta = DeltaBit != 0;
+
+	if (bIsDelta)
+	{
+		uint32 Age = BaselineAge;
+		Ar.SerializeInt(Age, FFGMovementHistory::Capacity);
+		BaselineAge = static_cast<uint8>(Age);
+	}
+
+	//Deltas are small, the packed location and timestamp shrink with them.
+	Move.SerializeBits(Ar, nullptr);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "../Components/Replicator/FGNetQuantize.h"
+#include "FGMovementData.generated.h"
+
+class AFGPlayer;
+class FBitWriter;
+
+//Wire precision for player moves, override these from Build.cs (PublicDefinitions) to trade precision for bandwidth.
+
+//Fixed point scale for locations, 10 = one millimeter.
+#ifndef FGNET_MOVE_LOCATION_SCALE
+#define FGNET_MOVE_LOCATION_SCALE 10
+#endif
+
+//Upper bound of bits per location component, locations with a component that does not fit are sent as full floats.
+#ifndef FGNET_MOVE_LOCATION_MAX_BITS
+#define FGNET_MOVE_LOCATION_MAX_BITS 24
+#endif
+
+//Send locations as a delta to the previous move in the same packet.
+#ifndef FGNET_MOVE_RELATIVE_LOCATION
+#define FGNET_MOVE_RELATIVE_LOCATION 1
+#endif
+
+//Bits per input axis, the axis keeps an exact zero.
+#ifndef FGNET_MOVE_INPUT_BITS
+#define FGNET_MOVE_INPUT_BITS 5
+#endif
+
+#ifndef FGNET_MOVE_YAW_BITS
+#define FGNET_MOVE_YAW_BITS 12
+#endif
+
+//Milliseconds between two moves in a packet, larger gaps fall back to a full timestamp.
+#ifndef FGNET_MOVE_TIME_DELTA_BITS
+#define FGNET_MOVE_TIME_DELTA_BITS 8
+#endif
+
+//Bits spent per field while serializing moves, see FGMovementData::MeasureBitBudget.
+struct FFGMoveBitBudget
+{
+	int64 LocationBits = 0;
+	int64 TimeStampBits = 0;
+	int64 InputBits = 0;
+	int64 BrakeBits = 0;
+	int64 YawBits = 0;
+	int64 HeaderBits = 0;
+	int32 NumMoves = 0;
+
+	int64 GetTotalBits() const { return LocationBits + TimeStampBits + InputBits + BrakeBits + YawBits + HeaderBits; }
+
+	FString ToString() const;
+};
+
+USTRUCT()
+struct FGMovementData
+{
+	GENERATED_USTRUCT_BODY()
+
+	FVector Location = FVector::ZeroVector;
+
+	float TimeStamp = 0.0f;
+
+	float Forward = 0.0f;
+
+	float Turn = 0.0f;
+
+	float Yaw = 0.0f;
+
+	bool bBrake = false;
+
+	//Moves with the same input can be merged into one without changing the outcome.
+	bool HasSameInput(const FGMovementData& Other) const
+	{
+		return Forward == Other.Forward && Turn == Other.Turn && bBrake == Other.bBrake;
+	}
+
+	//Rounds every field to wire precision, so the sender keeps exactly what the receiver will see.
+	void Quantize();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+	{
+		SerializeBits(Ar, nullptr);
+		bOutSuccess = !Ar.IsError();
+		return true;
+	}
+
+	//Location and timestamp are sent relative to PreviousMove when given, both sides must pass the same move.
+	void SerializeBits(FArchive& Ar, const FGMovementData* PreviousMove);
+
+	//Same as above, adding the bits each field took to Budget.
+	void SerializeBits(FBitWriter& Writer, const FGMovementData* PreviousMove, FFGMoveBitBudget& Budget);
+
+	//Location and timestamp as the difference to Baseline, which must be older. Input and yaw stay absolute.
+	FGMovementData MakeDelta(const FGMovementData& Baseline) const;
+
+	FGMovementData ApplyDelta(const FGMovementData& Baseline) const;
+
+	//Serializes the moves like a move packet would and reports where the bits went.
+	static void MeasureBitBudget(const TArray<FGMovementData>& Moves, FFGMoveBitBudget& OutBudget);
+
+	//What one move cost when it was sent as FVector + timestamp + forward + byte yaw.
+	static constexpr int32 UnpackedMoveBits = 96 + 32 + 32 + 9;
+
+private:
+
+	//BudgetWriter is Ar itself when measuring, passed separately so the archive is never downcast.
+	void SerializeBits(FArchive& Ar, const FGMovementData* PreviousMove, const FBitWriter* BudgetWriter, FFGMoveBitBudget* Budget);
+};
+
+template<>
+struct TStructOpsTypeTraits<FGMovementData> : public TStructOpsTypeTraitsBase2<FGMovementData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//All moves the client made since its last send, plus a few older ones the server has not acked yet in case that packet was lost.
+USTRUCT()
+struct FFGClientMovePacket
+{
+	GENERATED_USTRUCT_BODY()
+
+	static constexpr int32 MaxMoves = 32;
+
+	UPROPERTY()
+	TArray<FGMovementData> Moves;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGClientMovePacket> : public TStructOpsTypeTraitsBase2<FFGClientMovePacket>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//Authoritative state after the server simulated the client's moves up to TimeStamp.
+USTRUCT()
+struct FFGMoveAck
+{
+	GENERATED_USTRUCT_BODY()
+
+	float TimeStamp = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+
+	float Velocity = 0.0f;
+
+	float Yaw = 0.0f;
+
+	float Gravity = 0.0f;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
+	{
+		Ar << TimeStamp;
+		FFGNetQuantize::SerializeVector<FGNET_MOVE_LOCATION_SCALE, FGNET_MOVE_LOCATION_MAX_BITS>(Location, Ar);
+		Ar << Velocity;
+		Ar << Yaw;
+		Ar << Gravity;
+		bOutSuccess = !Ar.IsError();
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGMoveAck> : public TStructOpsTypeTraitsBase2<FFGMoveAck>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//Recent movement states of one player by sequence, to encode and decode deltas against. Both ends keep the same
+//number, the server only uses baselines young enough that the receiver cannot have overwritten them yet.
+class FGNET_API FFGMovementHistory
+{
+public:
+
+	static constexpr int32 Capacity = 16;
+
+	void Add(uint8 Sequence, const FGMovementData& Move);
+
+	const FGMovementData* Find(uint8 Sequence) const;
+
+private:
+
+	FGMovementData Moves[Capacity];
+
+	uint8 Sequences[Capacity] = {};
+
+	bool bIsValid[Capacity] = {};
+};
+
+//Server state of a player for one viewer, either in full or as a delta to a state the viewer acknowledged.
+USTRUCT()
+struct FFGMovementUpdate
+{
+	GENERATED_USTRUCT_BODY()
+
+	uint8 Sequence = 0;
+
+	bool bIsDelta = false;
+
+	//How many updates back the baseline was sent, only for deltas.
+	uint8 BaselineAge = 0;
+
+	//Relative to the baseline for deltas, see FGMovementData::MakeDelta.
+	FGMovementData Move;
+
+	uint8 GetBaselineSequence() const { return Sequence - BaselineAge; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFGMovementUpdate> : public TStructOpsTypeTraitsBase2<FFGMovementUpdate>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//The newest movement update a client got about one player, which becomes the baseline for the next ones.
+USTRUCT()
+struct FFGMovementUpdateAck
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	AFGPlayer* Mover = nullptr;
+
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	//The client could not decode a delta, the server goes back to full states until a new baseline is acked.
+	UPROPERTY()
+	bool bBaselineLost = false;
+};
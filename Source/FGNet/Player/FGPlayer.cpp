@@ -5,17 +5,67 @@
 #include "Components/SphereComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Engine/NetDriver.h"
+#include "Engine/GameInstance.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/Controller.h"
 #include "../Components/FGMovementComponent.h"
 #include "../FGMovementStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "FGPlayerSettings.h"
 #include "../Debug/UI/FGNetDebugWidget.h"
+#include "../Debug/FGNetTrafficSubsystem.h"
+#include "../Debug/FGNetTelemetrySubsystem.h"
+#include "../Debug/FGPredictionBenchmarkSubsystem.h"
 #include "../FGPickup.h"
+#include "../FGPickupManager.h"
+#include "../FGPickupSubsystem.h"
 #include "../FGRocket.h"
+#include "../FGRocketSubsystem.h"
+#include "../FGInterestSubsystem.h"
+#include "../FGNet.h"
 
+//Longest single movement step, longer moves are split into steps of at most this.
 const static float MaxMoveDeltaTime = 0.125f;
 
+//Most move time a client can have banked on the server. Its moves may only add up to the time that passed on the server,
+//this is the slack for packets arriving in bursts.
+const static float MaxMoveTimeBudget = 0.5f;
+
+//How far a client's fire event may be from the server's idea of where it is and where it faces.
+const static float MaxFireOriginError = 150.0f;
+const static float MaxFireAngleError = 20.0f;
+
+//Remote players further off than this from a received location are snapped to it.
+const static float SnapCorrectionThreshold = 40.0f;
+
+//How much further than touching a pickup a client may claim to be, the server sees it a little behind.
+const static float MaxPickupReachError = 150.0f;
+
+#if WITH_PUSH_MODEL
+//Push properties nobody marked dirty when AFGPlayer was up for replication. The replication system can skip comparing
+//these, how many comparisons it really skipped is not visible from here.
+DECLARE_DWORD_COUNTER_STAT(TEXT("Push Model Clean Properties"), STAT_FGNetPushModelCleanProperties, STATGROUP_FGNet);
+#endif
+
+//Every replicated property of AFGPlayer is push based, one bit each in DirtyPushProperties.
+enum EFGPushProperty : uint8
+{
+	PushProperty_ReplicatedYaw = 1 << 0,
+	PushProperty_CurrentHealth = 1 << 1,
+	PushProperty_NumRockets = 1 << 2,
+	PushProperty_ProcessedRocketFires = 1 << 3,
+};
+
+const static int32 NumPushProperties = 4;
+
+//Any write to a replicated property of AFGPlayer has to go through this or it will not be sent.
+#define FGNET_MARK_PROPERTY_DIRTY(PropertyName) \
+	{ \
+		MARK_PROPERTY_DIRTY_FROM_NAME(AFGPlayer, PropertyName, this); \
+		DirtyPushProperties |= PushProperty_##PropertyName; \
+	}
+
 AFGPlayer::AFGPlayer()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -47,7 +97,26 @@ void AFGPlayer::BeginPlay()
 
 	SpawnRockets();
 
+	if (UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>())
+	{
+		PickupSubsystem->RegisterPlayer(this);
+	}
+
+	if (HasAuthority())
+	{
+		if (UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>())
+		{
+			RocketSubsystem->RegisterPlayer(this);
+		}
+
+		if (UFGInterestSubsystem* InterestSubsystem = GetWorld()->GetSubsystem<UFGInterestSubsystem>())
+		{
+			InterestSubsystem->RegisterPlayer(this);
+		}
+	}
+
 	CurrentHealth = PlayerSettings->MaxHealth;
+	FGNET_MARK_PROPERTY_DIRTY(CurrentHealth);
 
 	MovementComponent->SetUpdatedComponent(CollisionComponent);
 
@@ -59,9 +128,161 @@ void AFGPlayer::BeginPlay()
 	}
 
 	BP_OnHealthChanged(CurrentHealth);
-	BP_OnNumRocketsChanged(NumRockets);
+	BP_OnNumRocketsChanged(GetNumRockets());
 
 	OriginalMeshOffset = MeshComponent->GetRelativeLocation();
+	PreviousStepLocation = GetActorLocation();
+}
+
+void AFGPlayer::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	if (NewController == nullptr || NewController->IsLocalController())
+	{
+		return;
+	}
+
+	//Rockets fired before this player joined are sent once, everything after comes as fire events.
+	//Only on the first possession, after a respawn the client already has every rocket in flight.
+	UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+
+	if (RocketSubsystem != nullptr && RocketSubsystem->MarkRocketSnapshotSent(NewController->GetNetConnection()))
+	{
+		FFGRocketSnapshot RocketSnapshot;
+		RocketSubsystem->GetFireEvents(RocketSnapshot.Rockets);
+
+		if (RocketSnapshot.Rockets.Num() > 0)
+		{
+			Client_ReceiveRocketSnapshot(RocketSnapshot);
+		}
+	}
+}
+
+void AFGPlayer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>())
+	{
+		RocketSubsystem->UnregisterPlayer(this);
+	}
+
+	if (UFGInterestSubsystem* InterestSubsystem = GetWorld()->GetSubsystem<UFGInterestSubsystem>())
+	{
+		InterestSubsystem->UnregisterPlayer(this);
+	}
+
+	if (UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>())
+	{
+		PickupSubsystem->UnregisterPlayer(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AFGPlayer::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+#if WITH_PUSH_MODEL
+	//Only counted when push model is on, without it every property is compared and none of them are clean.
+	if (IS_PUSH_MODEL_ENABLED())
+	{
+		INC_DWORD_STAT_BY(STAT_FGNetPushModelCleanProperties, NumPushProperties - FMath::CountBits(DirtyPushProperties));
+	}
+#endif
+
+#if FGNET_TRAFFIC_STATS
+	//Counted once per update, not once per connection it goes to.
+	UFGNetTrafficSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UFGNetTrafficSubsystem>();
+
+	if (TrafficSubsystem != nullptr && DirtyPushProperties != 0)
+	{
+		for (int32 Index = 0; Index < NumPushProperties; Index++)
+		{
+			if ((DirtyPushProperties & (1 << Index)) != 0)
+			{
+				TrafficSubsystem->RecordProperty(GetPushProperty(Index), this, false);
+			}
+		}
+	}
+#endif
+
+	DirtyPushProperties = 0;
+}
+
+void AFGPlayer::PreNetReceive()
+{
+	Super::PreNetReceive();
+
+#if FGNET_TRAFFIC_STATS
+	//The push properties are plain values, copied so PostNetReceive can tell which ones this update carried.
+	PreNetReceiveValues.Reset();
+
+	for (int32 Index = 0; Index < NumPushProperties; Index++)
+	{
+		const FProperty* Property = GetPushProperty(Index);
+		const int32 Offset = PreNetReceiveValues.AddUninitialized(Property->ElementSize);
+		Property->CopySingleValue(&PreNetReceiveValues[Offset], Property->ContainerPtrToValuePtr<void>(this));
+	}
+#endif
+}
+
+void AFGPlayer::PostNetReceive()
+{
+#if FGNET_TRAFFIC_STATS
+	//Replication only sends what changed, so a changed value is a received one. Counted before the rep notifies run.
+	UFGNetTrafficSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UFGNetTrafficSubsystem>();
+
+	if (TrafficSubsystem != nullptr && PreNetReceiveValues.Num() > 0)
+	{
+		int32 Offset = 0;
+
+		for (int32 Index = 0; Index < NumPushProperties; Index++)
+		{
+			const FProperty* Property = GetPushProperty(Index);
+
+			if (!Property->Identical(&PreNetReceiveValues[Offset], Property->ContainerPtrToValuePtr<void>(this)))
+			{
+				TrafficSubsystem->RecordProperty(Property, this, true);
+			}
+
+			Offset += Property->ElementSize;
+		}
+	}
+#endif
+
+	Super::PostNetReceive();
+}
+
+const FProperty* AFGPlayer::GetPushProperty(int32 Index)
+{
+	static const FProperty* PushProperties[NumPushProperties] =
+	{
+		FindFProperty<FProperty>(AFGPlayer::StaticClass(), GET_MEMBER_NAME_CHECKED(AFGPlayer, ReplicatedYaw)),
+		FindFProperty<FProperty>(AFGPlayer::StaticClass(), GET_MEMBER_NAME_CHECKED(AFGPlayer, CurrentHealth)),
+		FindFProperty<FProperty>(AFGPlayer::StaticClass(), GET_MEMBER_NAME_CHECKED(AFGPlayer, NumRockets)),
+		FindFProperty<FProperty>(AFGPlayer::StaticClass(), GET_MEMBER_NAME_CHECKED(AFGPlayer, ProcessedRocketFires)),
+	};
+
+	return PushProperties[Index];
+}
+
+bool AFGPlayer::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+#if FGNET_TRAFFIC_STATS
+	UFGNetTrafficSubsystem::RecordSentRpc(this, Function, Parameters);
+#endif
+
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void AFGPlayer::ProcessEvent(UFunction* Function, void* Parameters)
+{
+#if FGNET_TRAFFIC_STATS
+	UFGNetTrafficSubsystem::RecordProcessedRpc(this, Function, Parameters);
+#endif
+
+	Super::ProcessEvent(Function, Parameters);
 }
 
 void AFGPlayer::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -76,9 +297,31 @@ void AFGPlayer::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 	PlayerInputComponent->BindAction(TEXT("DebugMenu"), IE_Pressed, this, &AFGPlayer::Handle_DebugMenuPressed);
 }
 
-void AFGPlayer::OnHit(float DamageAmount)
+void AFGPlayer::OnHit(float DamageAmount, uint8 RocketId)
+{
+	//Hits are resolved on the server only, one damage event per hit.
+	if (HasAuthority())
+	{
+		Server_OnTakeDamage(DamageAmount, RocketId);
+	}
+}
+
+float AFGPlayer::GetCollisionRadius() const
 {
-	OnTakeDamage(DamageAmount);
+	return CollisionComponent->GetScaledSphereRadius();
+}
+
+float AFGPlayer::GetLagCompensationTime() const
+{
+	if (IsLocallyControlled() || GetPlayerState() == nullptr || PlayerSettings == nullptr)
+	{
+		return 0.0f;
+	}
+
+	//The fire reached us half a round trip late, and the shooter drew everyone else a playout delay in the past.
+	const float HalfRoundTripTime = GetPlayerState()->ExactPing * 0.001f * 0.5f;
+	const float ViewDelay = PlayerSettings->bUseSnapshotInterpolation ? PlayerSettings->MinPlayoutDelay : 0.0f;
+	return HalfRoundTripTime + ViewDelay;
 }
 
 void AFGPlayer::Tick(float DeltaTime)
@@ -92,34 +335,104 @@ void AFGPlayer::Tick(float DeltaTime)
 
 	FireCooldownElapsed -= DeltaTime;
 
-	FFGFrameMovement FrameMovement = MovementComponent->CreateFrameMovement();
-	FGMovementData MovementData;
+	if (HasAuthority())
+	{
+		TransformHistory.Add(GetWorld()->GetTimeSeconds(), GetActorLocation());
+		MoveTimeBudget = FMath::Min(MoveTimeBudget + DeltaTime, MaxMoveTimeBudget);
+	}
 
+	FFGFrameMovement FrameMovement = MovementComponent->CreateFrameMovement();
 
 	if (IsLocallyControlled())
 	{
-		ClientTimeStamp += DeltaTime;
+		const bool bFixedTimeStep = MovementComponent->bUseFixedTimeStep;
+		const int32 NumSteps = bFixedTimeStep ? MovementComponent->ConsumeFixedSteps(DeltaTime) : 1;
+		const float StepTime = bFixedTimeStep ? MovementComponent->FixedTimeStep : DeltaTime;
 
-		const float MaxVelocity = PlayerSettings->MaxVelocity;
-		const float Friction = IsBraking() ? PlayerSettings->BrakingFriction : PlayerSettings->Friction;
-		const float Alpha = FMath::Clamp(FMath::Abs(MovementVelocity / (PlayerSettings->MaxVelocity * 0.75f)), 0.0f, 1.0f);
-		const float TurnSpeed = FMath::InterpEaseOut(0.0f, PlayerSettings->TurnSpeedDefault, Alpha, 5.0f);
-		const float MovementDirection = MovementVelocity > 0.0f ? Turn : -Turn;
+		for (int32 Step = 0; Step < NumSteps; Step++)
+		{
+			PreviousStepLocation = GetActorLocation();
+			ClientTimeStamp += StepTime;
 
-		Yaw += (MovementDirection * TurnSpeed) * DeltaTime;
-		FQuat WantedFacingDirection = FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaw));
-		MovementComponent->SetFacingRotation(WantedFacingDirection);
+			FGMovementData MovementData;
+			MovementData.TimeStamp = ClientTimeStamp;
+			MovementData.Forward = Forward;
+			MovementData.Turn = Turn;
+			MovementData.bBrake = bBrake;
+			MovementData.Quantize();
 
-		AddMovementVelocity(DeltaTime);
-		MovementVelocity *= FMath::Pow(Friction, DeltaTime);
+			//Step with the quantized timestamps, that is what the server derives its step from.
+			const float MoveDeltaTime = MovementData.TimeStamp - LastMoveTimeStamp;
 
-		MovementData.Yaw = GetActorRotation().Yaw;
+			if (MoveDeltaTime <= 0.0f)
+			{
+				continue;
+			}
 
-		MovementComponent->ApplyGravity();
-		FrameMovement.AddDelta(GetActorForwardVector() * MovementVelocity * DeltaTime);
+			LastMoveTimeStamp = MovementData.TimeStamp;
+			FrameMovement = SimulateMove(MovementData, MoveDeltaTime);
 
-		MovementComponent->Move(FrameMovement);
-		Server_SendMovement(GetActorLocation(), ClientTimeStamp, Forward, MovementData);
+			MovementData.Location = FrameMovement.FinalLocation;
+			MovementData.Yaw = GetActorRotation().Yaw;
+			MovementData.Quantize();
+			MoveQueue.AddMove(MovementData, PlayerSettings->MaxMovesPerPacket);
+
+			if (IsPredictingMovement())
+			{
+				FFGPredictedMove PredictedMove;
+				PredictedMove.Move = MovementData;
+				PredictedMove.DeltaTime = MoveDeltaTime;
+				PredictedMove.Location = FrameMovement.FinalLocation;
+				PredictedMove.Velocity = MovementVelocity;
+				PredictedMove.Yaw = Yaw;
+				PredictedMove.Gravity = MovementComponent->GetAccumulatedGravity();
+				PredictedMoves.Add(PredictedMove);
+			}
+		}
+
+		//Fewer, fuller packets when the connection to the server is struggling.
+		MoveSendRate.Update(GetNetConnection(), DeltaTime, PlayerSettings->MovementSendRateSettings);
+		const int32 MinSendRate = FMath::Min(PlayerSettings->MinMovementSendRate, PlayerSettings->MovementSendRate);
+		const int32 SendRate = FMath::RoundToInt(MoveSendRate.GetRate(MinSendRate, PlayerSettings->MovementSendRate));
+
+		if (MoveQueue.TickSend(DeltaTime, SendRate))
+		{
+			FFGClientMovePacket MovePacket;
+			MoveQueue.BuildPacket(MovePacket, PlayerSettings->RedundantMoves, GetWorld()->GetRealTimeSeconds());
+			Server_SendMovement(MovePacket);
+			LastMovePacket = MovePacket;
+
+			if (PendingMovementUpdateAcks.Num() > 0)
+			{
+				Server_AckMovementUpdates(PendingMovementUpdateAcks);
+				PendingMovementUpdateAcks.Reset();
+			}
+		}
+
+		UpdateLocalMeshOffset(DeltaTime);
+	}
+
+	//The server moves client owned players only when their moves arrive.
+	else if (HasAuthority() && PlayerSettings->bServerAuthoritativeMovement)
+	{
+		return;
+	}
+
+	else if (UseSnapshotInterpolation())
+	{
+		FFGSnapshotBufferSettings SnapshotSettings;
+		SnapshotSettings.MinPlayoutDelay = PlayerSettings->MinPlayoutDelay;
+		SnapshotSettings.MaxPlayoutDelay = FMath::Max(PlayerSettings->MaxPlayoutDelay, PlayerSettings->MinPlayoutDelay);
+		SnapshotSettings.JitterMultiplier = PlayerSettings->PlayoutJitterMultiplier;
+		SnapshotSettings.MaxExtrapolationTime = PlayerSettings->MaxSnapshotExtrapolationTime;
+
+		FVector SnapshotLocation;
+		float SnapshotYaw = 0.0f;
+
+		if (SnapshotBuffer.Sample(GetWorld()->GetTimeSeconds(), DeltaTime, SnapshotSettings, SnapshotLocation, SnapshotYaw))
+		{
+			MovementComponent->UpdatedComponent->SetWorldLocationAndRotation(SnapshotLocation, FRotator(0.0f, SnapshotYaw, 0.0f), false, nullptr, ETeleportType::TeleportPhysics);
+		}
 	}
 
 	else
@@ -155,52 +468,156 @@ void AFGPlayer::Tick(float DeltaTime)
 	}
 }
 
-void AFGPlayer::SpawnRockets()
+FFGFrameMovement AFGPlayer::SimulateMove(const FGMovementData& Move, float DeltaTime)
 {
-	if (HasAuthority() && RocketClass != nullptr)
+	if (!MovementComponent->bUseFixedTimeStep)
 	{
-		const int32 RocketCache = 8;
+		//Merged moves and hitches are split, so a long move is not one big step.
+		const int32 NumSteps = FMath::Max(FMath::CeilToInt(DeltaTime / MaxMoveDeltaTime), 1);
+		const float StepTime = DeltaTime / NumSteps;
+		FFGFrameMovement FrameMovement = SimulateStep(Move, StepTime);
 
-		for (int32 Index = 0; Index < RocketCache; Index++)
+		for (int32 Step = 1; Step < NumSteps; Step++)
 		{
-			UFGRocket* Rocket = NewObject<UFGRocket>(RocketClass);
-
-			if (Rocket != nullptr && GetWorld() != nullptr)
-			{
-				Rocket->SetAbsolute(true);
-				Rocket->SetWorldLocation(GetActorLocation());
-				Rocket->RegisterComponentWithWorld(GetWorld());
-				Rocket->AttachTo(RootComponent);
-				RocketInstances.Add(Rocket);
-			}
+			FrameMovement = SimulateStep(Move, StepTime);
 		}
+
+		return FrameMovement;
 	}
+
+	//Both sides derive the step count from the move's duration, so a merged move runs the same steps as the frames it replaced.
+	const int32 NumSteps = MovementComponent->GetNumFixedSteps(DeltaTime);
+	FFGFrameMovement FrameMovement = SimulateStep(Move, MovementComponent->FixedTimeStep);
+
+	for (int32 Step = 1; Step < NumSteps; Step++)
+	{
+		FrameMovement = SimulateStep(Move, MovementComponent->FixedTimeStep);
+	}
+
+	return FrameMovement;
 }
 
-void AFGPlayer::HandleInvalidPickUp(AFGPickup* Pickup)
+FFGFrameMovement AFGPlayer::SimulateStep(const FGMovementData& Move, float DeltaTime)
 {
-	if (ServerNumRockets - Pickup->NumRockets >= 0)
+	FFGFrameMovement FrameMovement = MovementComponent->CreateFrameMovement();
+
+	const float Friction = Move.bBrake ? PlayerSettings->BrakingFriction : PlayerSettings->Friction;
+	const float Alpha = FMath::Clamp(FMath::Abs(MovementVelocity / (PlayerSettings->MaxVelocity * 0.75f)), 0.0f, 1.0f);
+	const float TurnSpeed = FMath::InterpEaseOut(0.0f, PlayerSettings->TurnSpeedDefault, Alpha, 5.0f);
+	const float MovementDirection = MovementVelocity > 0.0f ? Move.Turn : -Move.Turn;
+
+	Yaw += (MovementDirection * TurnSpeed) * DeltaTime;
+	FQuat WantedFacingDirection = FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+	MovementComponent->SetFacingRotation(WantedFacingDirection);
+
+	AddMovementVelocity(Move.Forward, DeltaTime);
+	MovementVelocity *= FMath::Pow(Friction, DeltaTime);
+
+	MovementComponent->ApplyGravity(DeltaTime);
+	FrameMovement.AddDelta(GetActorForwardVector() * MovementVelocity * DeltaTime);
+
+	MovementComponent->Move(FrameMovement);
+	return FrameMovement;
+}
+
+bool AFGPlayer::IsPredictingMovement() const
+{
+	return PlayerSettings != nullptr && PlayerSettings->bServerAuthoritativeMovement && IsLocallyControlled() && !HasAuthority();
+}
+
+bool AFGPlayer::UseSnapshotInterpolation() const
+{
+	//The server keeps its copies where the moves put them, it is what hits and pickups are tested against.
+	return PlayerSettings != nullptr && PlayerSettings->bUseSnapshotInterpolation && !HasAuthority();
+}
+
+void AFGPlayer::CorrectPrediction(const FFGMoveAck& MoveAck)
+{
+	const FVector LocationBeforeCorrection = GetActorLocation();
+
+	MovementComponent->UpdatedComponent->SetWorldLocation(MoveAck.Location, false, nullptr, ETeleportType::TeleportPhysics);
+	MovementVelocity = MoveAck.Velocity;
+	Yaw = MoveAck.Yaw;
+	MovementComponent->SetFacingRotation(FRotator(0.0f, Yaw, 0.0f));
+	MovementComponent->SetAccumulatedGravity(MoveAck.Gravity);
+
+	//Everything the server has not seen yet is replayed on top of its state.
+	for (int32 Index = 0; Index < PredictedMoves.Num(); Index++)
 	{
-		ServerNumRockets -= Pickup->NumRockets;
+		FFGPredictedMove& PredictedMove = PredictedMoves[Index];
+		const FFGFrameMovement FrameMovement = SimulateMove(PredictedMove.Move, PredictedMove.DeltaTime);
+
+		PredictedMove.Location = FrameMovement.FinalLocation;
+		PredictedMove.Velocity = MovementVelocity;
+		PredictedMove.Yaw = Yaw;
+		PredictedMove.Gravity = MovementComponent->GetAccumulatedGravity();
 	}
 
-	else
+	//Keep drawing the mesh where it was, the offset blends away in UpdateLocalMeshOffset.
+	const FVector CorrectionDelta = GetActorLocation() - LocationBeforeCorrection;
+	PreviousStepLocation += CorrectionDelta;
+
+	if (bPerformNetworkSmoothing)
+	{
+		CorrectionOffset -= CorrectionDelta;
+	}
+
+	NumPredictionCorrections++;
+
+	if (UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>())
 	{
-		ServerNumRockets = 0;
+		TelemetrySubsystem->AddPredictionCorrection(GetNetConnection());
 	}
 
-	if (NumRockets - Pickup->NumRockets >= 0)
+	if (UFGPredictionBenchmarkSubsystem* Benchmark = GetGameInstance()->GetSubsystem<UFGPredictionBenchmarkSubsystem>())
 	{
-		NumRockets -= Pickup->NumRockets;
+		Benchmark->AddPredictionCorrection(CorrectionDelta.Size());
 	}
+}
 
-	else
+void AFGPlayer::UpdateLocalMeshOffset(float DeltaTime)
+{
+	CorrectionOffset = FMath::VInterpTo(CorrectionOffset, FVector::ZeroVector, DeltaTime, 10.0f);
+
+	//Fixed steps run at their own rate, draw the mesh between the last two so it moves smoothly at any framerate.
+	const FVector StepOffset = (PreviousStepLocation - GetActorLocation()) * (1.0f - MovementComponent->GetFixedStepAlpha());
+	const FVector WorldOffset = CorrectionOffset + StepOffset;
+
+	const FVector NewRelativeLocation = OriginalMeshOffset + GetActorTransform().InverseTransformVectorNoScale(WorldOffset);
+	MeshComponent->SetRelativeLocation(NewRelativeLocation, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void AFGPlayer::SpawnRockets()
+{
+	//Every machine simulates its own rockets, the pool is filled over the next frames so joining does not hitch.
+	if (UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>())
+	{
+		RocketSubsystem->PrewarmRockets(RocketClass, RocketSubsystem->RocketsPrewarmedPerPlayer);
+	}
+}
+
+void AFGPlayer::FGNetRocketPool()
+{
+	UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+
+	if (RocketSubsystem == nullptr)
 	{
-		NumRockets = 0;
+		return;
 	}
 
-	Pickup->ReActivatePickup();
-	Multicast_OnNumRocketsChanged(NumRockets);
+	const FString Report = RocketSubsystem->GetPoolReport();
+	UE_LOG(LogFGNet, Display, TEXT("%s"), *Report);
+	GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green, Report);
+}
+
+void AFGPlayer::FGNetMoveBitBudget()
+{
+	FFGMoveBitBudget Budget;
+	FGMovementData::MeasureBitBudget(LastMovePacket.Moves, Budget);
+
+	const FString Report = Budget.ToString();
+	UE_LOG(LogFGNet, Display, TEXT("%s"), *Report);
+	GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green, Report);
 }
 
 int32 AFGPlayer::GetPing() const
@@ -213,23 +630,60 @@ int32 AFGPlayer::GetPing() const
 	return 0;
 }
 
-void AFGPlayer::Client_OnPickupRockets_Implementation(int32 PickedUpRockets)
+int32 AFGPlayer::GetNumRockets() const
+{
+	return FMath::Max(NumRockets - PendingRocketFires.Num(), 0);
+}
+
+void AFGPlayer::SetNumRockets(int32 NewNumRockets)
 {
-	NumRockets += PickedUpRockets;
-	BP_OnNumRocketsChanged(NumRockets);
-	Multicast_OnNumRocketsChanged(NumRockets);
+	NumRockets = FMath::Max(NewNumRockets, 0);
+	FGNET_MARK_PROPERTY_DIRTY(NumRockets);
+
+	//A listen server's own player never gets the OnRep.
+	if (IsLocallyControlled())
+	{
+		BP_OnNumRocketsChanged(GetNumRockets());
+	}
+}
+
+void AFGPlayer::OnRep_RocketInventory()
+{
+	//Shots the server has processed are in NumRockets now, or were rejected and never will be.
+	for (int32 Index = PendingRocketFires.Num() - 1; Index >= 0; Index--)
+	{
+		const uint8 Age = static_cast<uint8>(ProcessedRocketFires - 1 - PendingRocketFires[Index]);
+
+		if (Age < 128)
+		{
+			PendingRocketFires.RemoveAt(Index, 1, false);
+		}
+	}
+
+	BP_OnNumRocketsChanged(GetNumRockets());
 }
 
 void AFGPlayer::Server_OnPickup_Implementation(AFGPickup* Pickup)
 {
-	if (!Pickup->GetIsPickedUp())
+	const UFGPickupSubsystem* PickupSubsystem = GetWorld()->GetSubsystem<UFGPickupSubsystem>();
+	AFGPickupManager* PickupManager = AFGPickupManager::Get(GetWorld());
+
+	if (PickupSubsystem == nullptr || PickupManager == nullptr)
 	{
-		Client_OnPickupRockets(Pickup->NumRockets);
+		return;
 	}
 
-	else
+	//The client hid a pickup it was not near, it has to be told it is still there.
+	if (!PickupSubsystem->IsInReach(Pickup, GetActorLocation(), GetCollisionRadius(), MaxPickupReachError))
+	{
+		PickupManager->ResendState(Pickup);
+		return;
+	}
+
+	//Someone else got there first, the client already hid it and sees it again when the manager respawns it.
+	if (PickupManager->TryCollect(Pickup))
 	{
-		HandleInvalidPickUp(Pickup);
+		SetNumRockets(NumRockets + Pickup->NumRockets);
 	}
 }
 
@@ -242,7 +696,7 @@ void AFGPlayer::OnPickup(AFGPickup* Pickup)
 void AFGPlayer::OnTakeDamage(float DamageAmount)
 {
 	//Spawn effects and alike
-	Server_OnTakeDamage(DamageAmount);
+	Server_OnTakeDamage(DamageAmount, INDEX_NONE);
 }
 
 void AFGPlayer::OnHeal(float HealAmount)
@@ -251,18 +705,28 @@ void AFGPlayer::OnHeal(float HealAmount)
 	Server_OnHeal(HealAmount);
 }
 
-void AFGPlayer::Server_OnTakeDamage_Implementation(float DamageAmount)
+void AFGPlayer::Server_OnTakeDamage_Implementation(float DamageAmount, int32 RocketId)
 {
 	if (CurrentHealth - DamageAmount >= 0)
 	{
-		Multicast_OnTakeDamage(DamageAmount);
+		Multicast_OnTakeDamage(DamageAmount, RocketId);
 	}
 }
 
-void AFGPlayer::Multicast_OnTakeDamage_Implementation(float DamageAmount)
+void AFGPlayer::Multicast_OnTakeDamage_Implementation(float DamageAmount, int32 RocketId)
 {
 	CurrentHealth -= DamageAmount;
+	FGNET_MARK_PROPERTY_DIRTY(CurrentHealth);
 	BP_OnHealthChanged(CurrentHealth);
+
+	//In a two player session every rocket hit on the other player is one of ours.
+	if (!HasAuthority() && !IsLocallyControlled() && RocketId != INDEX_NONE)
+	{
+		if (UFGPredictionBenchmarkSubsystem* Benchmark = GetGameInstance()->GetSubsystem<UFGPredictionBenchmarkSubsystem>())
+		{
+			Benchmark->AddServerHit(static_cast<uint8>(RocketId));
+		}
+	}
 }
 
 void AFGPlayer::Server_OnHeal_Implementation(float HealAmount)
@@ -276,64 +740,350 @@ void AFGPlayer::Server_OnHeal_Implementation(float HealAmount)
 void AFGPlayer::Multicast_OnHeal_Implementation(float HealAmount)
 {
 	CurrentHealth += HealAmount;
+	FGNET_MARK_PROPERTY_DIRTY(CurrentHealth);
 	BP_OnHealthChanged(CurrentHealth);
 }
 
-void AFGPlayer::Multicast_OnNumRocketsChanged_Implementation(int32 NewRocketAmount)
+void AFGPlayer::Server_FireRocket_Implementation(FFGRocketFireEvent FireEvent)
 {
-	BP_OnNumRocketsChanged(NewRocketAmount);
-}
+	ProcessedRocketFires = FireEvent.RocketId + 1;
+	FGNET_MARK_PROPERTY_DIRTY(ProcessedRocketFires);
 
-void AFGPlayer::Server_FireRocket_Implementation(UFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation)
-{
-	if ((ServerNumRockets - 1) < 0 && !bUnlimitedRockets)
+	if (NumRockets <= 0 && !bUnlimitedRockets)
 	{
-		Client_RemoveRocket(NewRocket);
+		Client_RejectRocket(FireEvent.RocketId);
 	}
 
 	else
 	{
-		const float DeltaYaw = FMath::FindDeltaAngleDegrees(RocketFacingRotation.Yaw, GetActorForwardVector().Rotation().Yaw);
-		const FRotator NewFacingRotation = RocketFacingRotation + FRotator(0.0f, DeltaYaw, 0.0f);
-		ServerNumRockets--;
-		Multicast_FireRocket(NewRocket, RocketStartLocation, NewFacingRotation);
-		Multicast_OnNumRocketsChanged(ServerNumRockets);
+		UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+
+		//The client fired where it predicted itself to be, we allow that within limits and use our own state otherwise.
+		if (!FireEvent.Origin.Equals(GetRocketStartLocation(), MaxFireOriginError))
+		{
+			FireEvent.Origin = GetRocketStartLocation();
+		}
+
+		if (FVector::DotProduct(FireEvent.Direction, GetActorForwardVector()) < FMath::Cos(FMath::DegreesToRadians(MaxFireAngleError)))
+		{
+			FireEvent.Direction = GetActorForwardVector();
+		}
+
+		if (RocketSubsystem != nullptr)
+		{
+			const float ServerTime = RocketSubsystem->GetServerWorldTime();
+			FireEvent.FireTime = FMath::Clamp(FireEvent.FireTime, ServerTime - RocketSubsystem->MaxLagCompensationTime, ServerTime);
+		}
+
+		FireEvent.Quantize();
+		Multicast_FireRocket(FireEvent);
+
+		if (!bUnlimitedRockets)
+		{
+			SetNumRockets(NumRockets - 1);
+		}
+	}
+}
+
+void AFGPlayer::Client_RejectRocket_Implementation(uint8 RocketId)
+{
+	UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+	UFGRocket* Rocket = RocketSubsystem != nullptr ? RocketSubsystem->FindRocket(this, RocketId) : nullptr;
+
+	if (Rocket != nullptr)
+	{
+		Rocket->MakeFree();
 	}
 }
 
-void AFGPlayer::Client_RemoveRocket_Implementation(UFGRocket* RocketToRemove)
+void AFGPlayer::Client_ReceiveRocketSnapshot_Implementation(const FFGRocketSnapshot& RocketSnapshot)
 {
-	RocketToRemove->MakeFree();
+	for (const FFGRocketFireEvent& FireEvent : RocketSnapshot.Rockets)
+	{
+		UFGRocket* Rocket = GetFreeRocket();
+
+		if (Rocket == nullptr)
+		{
+			return;
+		}
+
+		//We don't know who fired it, which only matters for damage and that is the server's.
+		Rocket->StartMoving(FireEvent);
+	}
 }
 
 void AFGPlayer::Cheat_IncreaseRockets(int32 InNumRockets)
 {
-	if (IsLocallyControlled())
+	//The inventory is the server's, a client can no longer give itself rockets.
+	if (HasAuthority())
 	{
-		NumRockets += InNumRockets;
+		SetNumRockets(NumRockets + InNumRockets);
 	}
 }
 
-void AFGPlayer::Server_SendMovement_Implementation(const FVector& ClientLocation, float TimeStamp, float ClientForward, FGMovementData MovementData)
+void AFGPlayer::Server_SendMovement_Implementation(const FFGClientMovePacket& MovePacket)
 {
-	Multicast_SendMovement(ClientLocation, TimeStamp, ClientForward, MovementData);
+	if (MovePacket.Moves.Num() == 0 || !ensure(PlayerSettings != nullptr))
+	{
+		return;
+	}
+
+	//A listen server's own player already moved locally.
+	const bool bSimulateMoves = PlayerSettings->bServerAuthoritativeMovement && !IsLocallyControlled();
+
+	UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>();
+
+	if (TelemetrySubsystem != nullptr && !IsLocallyControlled())
+	{
+		if (MovePacket.Moves.Last().TimeStamp < ServerTimeStamp)
+		{
+			TelemetrySubsystem->AddOutOfOrder(GetNetConnection());
+		}
+
+		else
+		{
+			TelemetrySubsystem->AddArrival(GetNetConnection(), MovePacket.Moves.Last().TimeStamp, GetWorld()->GetTimeSeconds());
+		}
+	}
+
+	//Redundant moves we already have are skipped, only the newest one is relayed.
+	const FGMovementData* NewestMove = nullptr;
+
+	for (const FGMovementData& Move : MovePacket.Moves)
+	{
+		if (Move.TimeStamp <= ServerTimeStamp)
+		{
+			continue;
+		}
+
+		if (bSimulateMoves)
+		{
+			//A client clock running faster than ours gets no more move time than passed here, it is corrected instead.
+			const float MoveDeltaTime = FMath::Min(Move.TimeStamp - ServerTimeStamp, MoveTimeBudget);
+			MoveTimeBudget -= MoveDeltaTime;
+
+			if (MoveDeltaTime > 0.0f)
+			{
+				SimulateMove(Move, MoveDeltaTime);
+			}
+		}
+
+		ServerTimeStamp = Move.TimeStamp;
+		NewestMove = &Move;
+	}
+
+	if (NewestMove != nullptr)
+	{
+		FGMovementData NewState = *NewestMove;
+
+		if (bSimulateMoves)
+		{
+			NewState.Location = GetActorLocation();
+			NewState.Yaw = GetActorRotation().Yaw;
+			Forward = NewState.Forward;
+			Turn = NewState.Turn;
+			bBrake = NewState.bBrake;
+		}
+
+		//Sent on to the connections that care about this player by UFGInterestSubsystem.
+		ServerMovementState = NewState;
+		bHasServerMovementState = true;
+
+		//Trusted client locations are applied here, the server copy does not run the moves.
+		if (!bSimulateMoves && !IsLocallyControlled())
+		{
+			ReceiveMovement(NewState);
+		}
+	}
+
+	//Ack even if everything was old, the previous ack might have been lost.
+	FFGMoveAck MoveAck;
+	MoveAck.TimeStamp = ServerTimeStamp;
+	MoveAck.Location = GetActorLocation();
+	MoveAck.Velocity = MovementVelocity;
+	MoveAck.Yaw = Yaw;
+	MoveAck.Gravity = MovementComponent->GetAccumulatedGravity();
+	Client_AckMove(MoveAck);
 }
 
-void AFGPlayer::Multicast_SendMovement_Implementation(const FVector& InClientLocation, float TimeStamp, float ClientForward, FGMovementData MovementData)
+void AFGPlayer::Client_AckMove_Implementation(FFGMoveAck MoveAck)
 {
-	if (!IsLocallyControlled())
+	UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>();
+
+	//Unreliable, an older ack can arrive after a newer one.
+	if (MoveAck.TimeStamp <= LastAckedTimeStamp)
+	{
+		if (TelemetrySubsystem != nullptr && MoveAck.TimeStamp < LastAckedTimeStamp)
+		{
+			TelemetrySubsystem->AddOutOfOrder(GetNetConnection());
+		}
+
+		return;
+	}
+
+	//Timed from when the packet that got acked went out, a move can wait in the queue for a while before that.
+	float SendTime = 0.0f;
+
+	if (TelemetrySubsystem != nullptr && MoveQueue.FindSendTime(MoveAck.TimeStamp, SendTime))
+	{
+		const float ArrivalTime = GetWorld()->GetRealTimeSeconds();
+		TelemetrySubsystem->AddRttSample(GetNetConnection(), ArrivalTime - SendTime);
+		TelemetrySubsystem->AddArrival(GetNetConnection(), SendTime, ArrivalTime);
+	}
+
+	LastAckedTimeStamp = MoveAck.TimeStamp;
+	MoveQueue.AckMoves(MoveAck.TimeStamp);
+
+	if (!IsPredictingMovement())
 	{
-		Forward = ClientForward;
-		const float DeltaTime = FMath::Min(TimeStamp - ClientTimeStamp, MaxMoveDeltaTime);
-		ClientTimeStamp = TimeStamp;
-		AddMovementVelocity(DeltaTime);
+		return;
+	}
+
+	FFGPredictedMove AckedMove;
+	const bool bFoundMove = PredictedMoves.PopUntil(MoveAck.TimeStamp, AckedMove);
+
+	if (bFoundMove
+		&& AckedMove.Location.Equals(MoveAck.Location, PlayerSettings->MaxPredictionError)
+		&& FMath::IsNearlyEqual(AckedMove.Velocity, MoveAck.Velocity, PlayerSettings->MaxPredictionError))
+	{
+		return;
+	}
+
+	CorrectPrediction(MoveAck);
+}
+
+void AFGPlayer::Client_ReceiveMovement_Implementation(AFGPlayer* Mover, const FFGMovementUpdate& Update)
+{
+	//The mover can be gone or not replicated to us yet.
+	if (Mover == nullptr || Mover == this)
+	{
+		return;
+	}
+
+	FGMovementData MovementData;
+
+	if (!Mover->DecodeMovementUpdate(Update, MovementData))
+	{
+		AddMovementUpdateAck(Mover, Update.Sequence, true);
+		return;
+	}
+
+	AddMovementUpdateAck(Mover, Update.Sequence, false);
+	Mover->ReceiveMovement(MovementData);
+}
+
+void AFGPlayer::Server_AckMovementUpdates_Implementation(const TArray<FFGMovementUpdateAck>& Acks)
+{
+	UFGInterestSubsystem* InterestSubsystem = GetWorld()->GetSubsystem<UFGInterestSubsystem>();
+
+	if (InterestSubsystem == nullptr)
+	{
+		return;
+	}
+
+	for (const FFGMovementUpdateAck& Ack : Acks)
+	{
+		InterestSubsystem->AckMovementUpdate(this, Ack.Mover, Ack.Sequence, Ack.bBaselineLost);
+	}
+}
+
+bool AFGPlayer::DecodeMovementUpdate(const FFGMovementUpdate& Update, FGMovementData& OutMovementData)
+{
+	if (Update.bIsDelta)
+	{
+		//Gone when this player stopped being relevant to us for a while and was created again.
+		const FGMovementData* Baseline = ReceivedMovement.Find(Update.GetBaselineSequence());
+
+		if (Baseline == nullptr)
+		{
+			return false;
+		}
+
+		OutMovementData = Update.Move.ApplyDelta(*Baseline);
+	}
+
+	else
+	{
+		OutMovementData = Update.Move;
+	}
+
+	ReceivedMovement.Add(Update.Sequence, OutMovementData);
+	return true;
+}
+
+void AFGPlayer::AddMovementUpdateAck(AFGPlayer* Mover, uint8 Sequence, bool bBaselineLost)
+{
+	FFGMovementUpdateAck* Ack = PendingMovementUpdateAcks.FindByPredicate([Mover](const FFGMovementUpdateAck& InAck) { return InAck.Mover == Mover; });
+
+	if (Ack == nullptr)
+	{
+		Ack = &PendingMovementUpdateAcks.AddDefaulted_GetRef();
+		Ack->Mover = Mover;
+		Ack->Sequence = Sequence;
+		Ack->bBaselineLost = bBaselineLost;
+	}
+
+	//Only the newest update matters, if it could be decoded the server may keep building on it.
+	else if (static_cast<int8>(Sequence - Ack->Sequence) > 0)
+	{
+		Ack->Sequence = Sequence;
+		Ack->bBaselineLost = bBaselineLost;
+	}
+}
+
+void AFGPlayer::ReceiveMovement(const FGMovementData& MovementData)
+{
+	//With authoritative movement the server is already where it sent us.
+	const bool bIsMovementAuthority = HasAuthority() && PlayerSettings != nullptr && PlayerSettings->bServerAuthoritativeMovement;
+
+	UFGPredictionBenchmarkSubsystem* Benchmark = !IsLocallyControlled() && !HasAuthority() ? GetGameInstance()->GetSubsystem<UFGPredictionBenchmarkSubsystem>() : nullptr;
+	const bool bMeasureProxyError = Benchmark != nullptr && Benchmark->IsRecording();
+
+	//Without a playout delay the proxy is supposed to be where the update says by now.
+	if (bMeasureProxyError && !UseSnapshotInterpolation())
+	{
+		Benchmark->AddProxyError(FVector::Distance(GetActorLocation(), MovementData.Location));
+	}
+
+	if (!IsLocallyControlled() && UseSnapshotInterpolation())
+	{
+		Forward = MovementData.Forward;
+		bBrake = MovementData.bBrake;
+
+		FFGSnapshot Snapshot;
+		Snapshot.TimeStamp = MovementData.TimeStamp;
+		Snapshot.Location = MovementData.Location;
+		Snapshot.Yaw = MovementData.Yaw;
+		SnapshotBuffer.AddSnapshot(Snapshot, GetWorld()->GetTimeSeconds());
+
+		//Drawn a playout delay behind on purpose, so compared with where the sender was at the time we last drew.
+		FVector PlayoutLocation;
+
+		if (bMeasureProxyError && SnapshotBuffer.GetLocationAt(SnapshotBuffer.GetPlayoutTime(), PlayoutLocation))
+		{
+			Benchmark->AddProxyError(FVector::Distance(GetActorLocation(), PlayoutLocation));
+		}
+	}
+
+	else if (!IsLocallyControlled() && !bIsMovementAuthority)
+	{
+		const FVector& InClientLocation = MovementData.Location;
+		Forward = MovementData.Forward;
+		const float DeltaTime = FMath::Min(MovementData.TimeStamp - ClientTimeStamp, MaxMoveDeltaTime);
+		ClientTimeStamp = MovementData.TimeStamp;
+		AddMovementVelocity(Forward, DeltaTime);
 
 		MovementComponent->SetFacingRotation(FRotator(0.0f, MovementData.Yaw, 0.0f));
 
 		const FVector DeltaDiff = InClientLocation - GetActorLocation();
 
-		if (DeltaDiff.SizeSquared() > FMath::Square(40.0f))
+		if (DeltaDiff.SizeSquared() > FMath::Square(SnapCorrectionThreshold))
 		{
+			if (UFGNetTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UFGNetTelemetrySubsystem>())
+			{
+				TelemetrySubsystem->AddSnapCorrection(GetNetConnection());
+			}
+
 			if (bPerformNetworkSmoothing)
 			{
 				const FScopedPreventAttachedComponentMove PreventMeshMove(MeshComponent);
@@ -349,22 +1099,31 @@ void AFGPlayer::Multicast_SendMovement_Implementation(const FVector& InClientLoc
 	}
 }
 
-void AFGPlayer::Multicast_FireRocket_Implementation(UFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation)
+void AFGPlayer::Multicast_FireRocket_Implementation(FFGRocketFireEvent FireEvent)
 {
-	if (!ensure(NewRocket != nullptr))
-	{
-		return;
-	}
-
 	if (GetLocalRole() == ROLE_AutonomousProxy)
 	{
-		NewRocket->ApplyCorrection(RocketFacingRotation.Vector());
+		//Our predicted rocket moves onto the server's path, if it is still flying.
+		UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+		UFGRocket* PredictedRocket = RocketSubsystem != nullptr ? RocketSubsystem->FindRocket(this, FireEvent.RocketId) : nullptr;
+
+		if (PredictedRocket != nullptr)
+		{
+			PredictedRocket->StartMoving(FireEvent, this);
+		}
 	}
 
 	else
 	{
-		NumRockets--;
-		NewRocket->StartMoving(RocketFacingRotation.Vector(), RocketStartLocation);
+		//Pooled rockets only exist locally, anyone but the shooter's own machine takes one from its own pool.
+		UFGRocket* NewRocket = GetFreeRocket();
+
+		if (NewRocket == nullptr)
+		{
+			return;
+		}
+
+		NewRocket->StartMoving(FireEvent, this, HasAuthority() ? GetLagCompensationTime() : 0.0f);
 	}
 }
 
@@ -376,25 +1135,14 @@ FVector AFGPlayer::GetRocketStartLocation() const
 
 UFGRocket* AFGPlayer::GetFreeRocket() const
 {
-	for (UFGRocket* Rocket : RocketInstances)
-	{
-		if (Rocket == nullptr)
-		{
-			continue;
-		}
-
-		if (Rocket->IsFree())
-		{
-			return Rocket;
-		}
-	}
-
-	return nullptr;
+	UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
+	return RocketSubsystem != nullptr ? RocketSubsystem->AcquireRocket(RocketClass) : nullptr;
 }
 
 void AFGPlayer::Server_SendYaw_Implementation(float NewYaw)
 {
 	ReplicatedYaw = NewYaw;
+	FGNET_MARK_PROPERTY_DIRTY(ReplicatedYaw);
 }
 
 void AFGPlayer::Handle_Acceleration(float Value)
@@ -407,6 +1155,21 @@ void AFGPlayer::Handle_Turn(float Value)
 	Turn = Value;
 }
 
+void AFGPlayer::SetScriptedInput(float InForward, float InTurn, bool bInBrake)
+{
+	Forward = InForward;
+	Turn = InTurn;
+	bBrake = bInBrake;
+}
+
+void AFGPlayer::Client_StartPredictionBenchmark_Implementation(float StartTime)
+{
+	if (UFGPredictionBenchmarkSubsystem* Benchmark = GetGameInstance()->GetSubsystem<UFGPredictionBenchmarkSubsystem>())
+	{
+		Benchmark->SetStartTime(StartTime);
+	}
+}
+
 void AFGPlayer::Handle_BrakePressed()
 {
 	bBrake = true;
@@ -473,7 +1236,7 @@ void AFGPlayer::HideDebugMenu()
 
 int32 AFGPlayer::GetNumActiveRockets() const
 {
-	return NumRockets;
+	return GetNumRockets();
 }
 
 void AFGPlayer::FireRocket()
@@ -483,7 +1246,7 @@ void AFGPlayer::FireRocket()
 		return;
 	}
 
-	if (NumRockets <= 0 && !bUnlimitedRockets)
+	if (GetNumRockets() <= 0 && !bUnlimitedRockets)
 	{
 		return;
 	}
@@ -493,32 +1256,50 @@ void AFGPlayer::FireRocket()
 		return;
 	}
 
-	UFGRocket* NewRocket = GetFreeRocket();
+	UFGRocketSubsystem* RocketSubsystem = GetWorld()->GetSubsystem<UFGRocketSubsystem>();
 
-	if (!ensure(NewRocket != nullptr))
+	if (RocketSubsystem == nullptr || GetLocalRole() < ROLE_AutonomousProxy)
 	{
 		return;
 	}
 
-	FireCooldownElapsed = PlayerSettings->FireCooldown;
+	FFGRocketFireEvent FireEvent;
+	FireEvent.RocketId = NextRocketId++;
+	FireEvent.Origin = GetRocketStartLocation();
+	FireEvent.Direction = GetActorForwardVector();
+	FireEvent.FireTime = RocketSubsystem->GetServerWorldTime();
+	FireEvent.Quantize();
 
-	if (GetLocalRole() >= ROLE_AutonomousProxy)
+	if (HasAuthority())
+	{
+		FireCooldownElapsed = PlayerSettings->FireCooldown;
+		Server_FireRocket(FireEvent);
+	}
+
+	else
 	{
-		if (HasAuthority())
+		//The pool is at its limit.
+		UFGRocket* NewRocket = GetFreeRocket();
+
+		if (NewRocket == nullptr)
 		{
-			Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation());
+			return;
 		}
 
-		else
+		FireCooldownElapsed = PlayerSettings->FireCooldown;
+		NewRocket->StartMoving(FireEvent, this);
+		Server_FireRocket(FireEvent);
+
+		//Taken out of the count right away, OnRep_RocketInventory puts it back if the server says no.
+		if (!bUnlimitedRockets)
 		{
-			NumRockets--;
-			NewRocket->StartMoving(GetActorForwardVector(), GetRocketStartLocation());
-			Server_FireRocket(NewRocket, GetRocketStartLocation(), GetActorRotation());
+			PendingRocketFires.Add(FireEvent.RocketId);
+			BP_OnNumRocketsChanged(GetNumRockets());
 		}
 	}
 }
 
-void AFGPlayer::AddMovementVelocity(float DeltaTime)
+void AFGPlayer::AddMovementVelocity(float InForward, float DeltaTime)
 {
 	if (!ensure(PlayerSettings != nullptr))
 	{
@@ -528,7 +1309,7 @@ void AFGPlayer::AddMovementVelocity(float DeltaTime)
 	const float MaxVelocity = PlayerSettings->MaxVelocity;
 	const float Acceleration = PlayerSettings->Acceleration;
 
-	MovementVelocity += Forward * Acceleration * DeltaTime;
+	MovementVelocity += InForward * Acceleration * DeltaTime;
 	MovementVelocity = FMath::Clamp(MovementVelocity, -MaxVelocity, MaxVelocity);
 }
 
@@ -555,8 +1336,16 @@ void AFGPlayer::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AFGPlayer, ReplicatedYaw);
-	DOREPLIFETIME(AFGPlayer, CurrentHealth);
-	DOREPLIFETIME(AFGPlayer, ReplicatedLocation);
-	DOREPLIFETIME(AFGPlayer, RocketInstances);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPlayer, ReplicatedYaw, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPlayer, CurrentHealth, Params);
+
+	FDoRepLifetimeParams OwnerOnlyParams;
+	OwnerOnlyParams.bIsPushBased = true;
+	OwnerOnlyParams.Condition = COND_OwnerOnly;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPlayer, NumRockets, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFGPlayer, ProcessedRocketFires, OwnerOnlyParams);
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "GameFramework/Pawn.h"
+#include "FGMovementData.h"
+#include "FGMoveQueue.h"
+#include "FGSendRateController.h"
+#include "FGSnapshotBuffer.h"
+#include "FGTransformHistory.h"
+#include "../FGRocketFireEvent.h"
 #include "FGPlayer.generated.h"
 
 class UCameraComponent;
@@ -12,73 +18,32 @@ class UFGPlayerSettings;
 class UFGNetDebugWidget;
 class AFGPickup;
 class UFGRocket;
+struct FFGFrameMovement;
 
-USTRUCT()
-struct FGMovementData
+UCLASS()
+class FGNET_API AFGPlayer : public APawn
 {
-	GENERATED_USTRUCT_BODY()
-
-	float Yaw = 0.0f;
-
-	bool NetSerialize(FArchive& Ar, class UPackageMap* PackageMap, bool& bOutSuccess)
-	{
-		SerializeCompressed(Ar);
-		FRotator Rot;
-		bOutSuccess = true;
-		return true;
-	}
-
-private:
-
-	void SerializeCompressed(FArchive& Ar)
-	{
-		const bool bArLoading = Ar.IsLoading();
+	GENERATED_BODY()
 
-		uint8 ByteYaw = 0;
+public:
+	AFGPlayer();
 
-		if (!bArLoading)
-		{
-			ByteYaw = FRotator::CompressAxisToByte(Yaw);
-		}
+	virtual void BeginPlay();
 
-		uint8 B = (ByteYaw != 0);
-		Ar.SerializeBits(&B, 1);
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-		if (B)
-		{
-			Ar << ByteYaw;
-		}
+	virtual void PossessedBy(AController* NewController) override;
 
-		else
-		{
-			ByteYaw = 0;
-		}
 
-		if (bArLoading)
-		{
-			Yaw = FRotator::DecompressAxisFromByte(ByteYaw);
-		}
-	}
-};
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
-template<>
-struct TStructOpsTypeTraits<FGMovementData> : public TStructOpsTypeTraitsBase2<FGMovementData>
-{
-	enum
-	{
-		WithNetSerializer = true,
-	};
-};
+	virtual void PreNetReceive() override;
 
-UCLASS()
-class FGNET_API AFGPlayer : public APawn
-{
-	GENERATED_BODY()
+	virtual void PostNetReceive() override;
 
-public:
-	AFGPlayer();
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
 
-	virtual void BeginPlay();
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) override;
 
 	virtual void Tick(float DeltaTime) override;
 
@@ -105,17 +70,32 @@ public:
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	//RocketId is the shooter's id of the rocket that hit.
 	UFUNCTION()
-	void OnHit(float DamageAmount);
+	void OnHit(float DamageAmount, uint8 RocketId);
 
-	UFUNCTION(Client, Reliable)
-	void Client_OnPickupRockets(int32 PickedUpRockets);
+	const FFGTransformHistory& GetTransformHistory() const { return TransformHistory; }
+
+	float GetCollisionRadius() const;
+
+	//How far in the past this player saw the others when firing, as the server estimates it.
+	float GetLagCompensationTime() const;
+
+	//Server only, the newest movement state to send to the connections interested in this player.
+	const FGMovementData& GetServerMovementState() const { return ServerMovementState; }
+
+	bool HasServerMovementState() const { return bHasServerMovementState; }
 
+	//Called on the viewer's own player, per connection instead of a multicast so the owner is left out.
+	UFUNCTION(Client, Unreliable)
+	void Client_ReceiveMovement(AFGPlayer* Mover, const FFGMovementUpdate& Update);
+
+	//RocketId is INDEX_NONE for damage that did not come from a rocket.
 	UFUNCTION(Server, Reliable)
-	void Server_OnTakeDamage(float DamageAmount);
+	void Server_OnTakeDamage(float DamageAmount, int32 RocketId);
 
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_OnTakeDamage(float DamageAmount);
+	void Multicast_OnTakeDamage(float DamageAmount, int32 RocketId);
 
 	UFUNCTION(Server, Reliable)
 	void Server_OnHeal(float HealAmount);
@@ -126,11 +106,9 @@ public:
 	UFUNCTION(Server, Unreliable)
 	void Server_SendYaw(float NewYaw);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_OnNumRocketsChanged(int32 NewRocketAmount);
-
+	//On the owning client this includes shots the server has not confirmed yet.
 	UFUNCTION(BlueprintPure)
-	int32 GetNumRockets() const { return NumRockets; }
+	int32 GetNumRockets() const;
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Player, meta = (DisplayName = "On Num Rockets Changed"))
 	void BP_OnNumRocketsChanged(int32 NewNumRockets);
@@ -152,20 +130,43 @@ public:
 
 	void FireRocket();
 
+	//Drives the player without an input component, for bots. Input bound to the player would overwrite it.
+	void SetScriptedInput(float InForward, float InTurn, bool bInBrake);
+
+	//Tells a prediction benchmark bot the server world time its first profile starts at.
+	UFUNCTION(Client, Reliable)
+	void Client_StartPredictionBenchmark(float StartTime);
+
 	void SpawnRockets();
 
-	void HandleInvalidPickUp(AFGPickup* Pickup);
+	//Prints where the bits of the last move packet went.
+	UFUNCTION(Exec)
+	void FGNetMoveBitBudget();
+
+	//Prints how many rockets the world pool created and the most that were in use at once.
+	UFUNCTION(Exec)
+	void FGNetRocketPool();
 
 public:
 	UPROPERTY(Replicated)
 	float CurrentHealth = 0.0f;
 
-	UPROPERTY(Replicated, Transient, BlueprintReadWrite, Category = Weapon)
-	TArray<UFGRocket*> RocketInstances;
-
 private:
 
-	void AddMovementVelocity(float DeltaTime);
+	void AddMovementVelocity(float InForward, float DeltaTime);
+
+	//Runs one move's input through the movement component, used for local moves, server moves and replays alike.
+	FFGFrameMovement SimulateMove(const FGMovementData& Move, float DeltaTime);
+
+	FFGFrameMovement SimulateStep(const FGMovementData& Move, float DeltaTime);
+
+	void UpdateLocalMeshOffset(float DeltaTime);
+
+	bool IsPredictingMovement() const;
+
+	bool UseSnapshotInterpolation() const;
+
+	void CorrectPrediction(const FFGMoveAck& MoveAck);
 
 	void CreateDebugWidget();
 
@@ -180,22 +181,36 @@ private:
 	UFGRocket* GetFreeRocket() const;
 
 	UFUNCTION(Server, Reliable)
-	void Server_FireRocket(UFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation);
+	void Server_FireRocket(FFGRocketFireEvent FireEvent);
 	
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_FireRocket(UFGRocket* NewRocket, const FVector& RocketStartLocation, const FRotator& RocketFacingRotation);
+	void Multicast_FireRocket(FFGRocketFireEvent FireEvent);
 	
 	UFUNCTION(Client, Reliable)
-	void Client_RemoveRocket(UFGRocket* RocketToRemove);
+	void Client_RejectRocket(uint8 RocketId);
+
+	UFUNCTION(Client, Reliable)
+	void Client_ReceiveRocketSnapshot(const FFGRocketSnapshot& RocketSnapshot);
 	
 	UFUNCTION(BlueprintCallable)
 	void Cheat_IncreaseRockets(int32 InNumRockets);
 
 	UFUNCTION(Server, Unreliable)
-	void Server_SendMovement(const FVector& ClientLocation, float TimeStamp, float ClientForward, FGMovementData MovementData);
+	void Server_SendMovement(const FFGClientMovePacket& MovePacket);
+
+	UFUNCTION(Client, Unreliable)
+	void Client_AckMove(FFGMoveAck MoveAck);
+
+	//Sent along with the move packets, one ack per player we got movement for since the last one.
+	UFUNCTION(Server, Unreliable)
+	void Server_AckMovementUpdates(const TArray<FFGMovementUpdateAck>& Acks);
+
+	//Returns false when the update is a delta to a state we no longer have.
+	bool DecodeMovementUpdate(const FFGMovementUpdate& Update, FGMovementData& OutMovementData);
+
+	void AddMovementUpdateAck(AFGPlayer* Mover, uint8 Sequence, bool bBaselineLost);
 
-	UFUNCTION(NetMulticast, Unreliable)
-	void Multicast_SendMovement(const FVector& InClientLocation, float TimeStamp, float ClientForward, FGMovementData MovementData);
+	void ReceiveMovement(const FGMovementData& MovementData);
 
 private:
 	
@@ -209,6 +224,8 @@ private:
 
 	float FireCooldownElapsed = 0.0f;
 
+	uint8 NextRocketId = 0;
+
 	UPROPERTY(EditAnywhere, Category = Weapon)
 	bool bUnlimitedRockets = false;
 
@@ -216,6 +233,42 @@ private:
 	float LastCorrectionDelta = 0.0f;
 	float ServerTimeStamp = 0.0f;
 
+	FFGClientMoveQueue MoveQueue;
+
+	FFGSendRateController MoveSendRate;
+
+	FFGClientMovePacket LastMovePacket;
+
+	//Owning client, acks for the next move packet.
+	TArray<FFGMovementUpdateAck> PendingMovementUpdateAcks;
+
+	//On other clients, the states of this player they received, to decode deltas against.
+	FFGMovementHistory ReceivedMovement;
+
+	FFGPredictedMoveBuffer PredictedMoves;
+
+	//Received states of a remote player, played back with a delay.
+	FFGSnapshotBuffer SnapshotBuffer;
+
+	//Server only, where this player was over the last second.
+	FFGTransformHistory TransformHistory;
+
+	FGMovementData ServerMovementState;
+
+	bool bHasServerMovementState = false;
+
+	float LastMoveTimeStamp = 0.0f;
+
+	//Server only, move time the client may still use up, refilled by the time passing on the server.
+	float MoveTimeBudget = 0.0f;
+	float LastAckedTimeStamp = 0.0f;
+
+	int32 NumPredictionCorrections = 0;
+
+	FVector PreviousStepLocation = FVector::ZeroVector;
+
+	FVector CorrectionOffset = FVector::ZeroVector;
+
 	UPROPERTY(EditAnywhere, Category = Network)
 	bool bPerformNetworkSmoothing = true;
 
@@ -223,10 +276,24 @@ private:
 
 	FVector OriginalMeshOffset = FVector::ZeroVector;
 
-	int32 ServerNumRockets = 0;
+	//Server only. Changes the inventory, the owner gets it through replication.
+	void SetNumRockets(int32 NewNumRockets);
+
+	UFUNCTION()
+	void OnRep_RocketInventory();
 
+	//Only the owner sees the inventory, the server's count is the real one.
+	UPROPERTY(ReplicatedUsing = OnRep_RocketInventory)
 	int32 NumRockets = 0;
 
+	//How many fire events the server has processed, accepted or not, wrapping. Rocket ids are handed out in order, so
+	//this is the id after the newest one the server has seen.
+	UPROPERTY(ReplicatedUsing = OnRep_RocketInventory)
+	uint8 ProcessedRocketFires = 0;
+
+	//Ids of shots the owning client already took out of its count that the server has not processed yet.
+	TArray<uint8> PendingRocketFires;
+
 	UPROPERTY(VisibleDefaultsOnly, Category = "Collision")
 	USphereComponent* CollisionComponent;
 
@@ -252,8 +319,14 @@ private:
 	UPROPERTY(Replicated)
 	float ReplicatedYaw = 0.0f;
 
-	UPROPERTY(Replicated)
-	FVector ReplicatedLocation = FVector::ZeroVector;
+	//Push model properties marked dirty since the last net update, one bit each.
+	uint8 DirtyPushProperties = 0;
+
+	//In the same order as the bits in DirtyPushProperties.
+	static const FProperty* GetPushProperty(int32 Index);
+
+	//Push property values from before the net update being received, only filled when traffic stats are on.
+	TArray<uint8> PreNetReceiveValues;
 
 	float Forward = 0.0f;
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "FGSendRateController.h"
 #include "FGPlayerSettings.generated.h"
 
 /**
@@ -35,4 +36,50 @@ public:
 
 	UPROPERTY(EditAnywhere, Category = Health, meta = (ClampMin = 1.0f))
 	float MaxHealth = 10.0f;
+
+	//How many movement packets per second the client sends, independent of framerate.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 1))
+	int32 MovementSendRate = 30;
+
+	//What the send rate drops to on a congested connection, moves are merged into fewer packets.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 1))
+	int32 MinMovementSendRate = 10;
+
+	UPROPERTY(EditAnywhere, Category = Network)
+	FFGSendRateSettings MovementSendRateSettings;
+
+	//Already sent but unacknowledged moves to send again with every packet, so a lost packet costs no moves.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0))
+	int32 RedundantMoves = 3;
+
+	//New moves per packet before it is sent early, moves are only merged when their input is the same.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 1))
+	int32 MaxMovesPerPacket = 8;
+
+	//Clients send input and predict, the server simulates it and corrects the client. Off means the server trusts client locations.
+	UPROPERTY(EditAnywhere, Category = Network)
+	bool bServerAuthoritativeMovement = true;
+
+	//How far the predicted state may be from the server state before the client corrects and replays its moves.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, EditCondition = "bServerAuthoritativeMovement"))
+	float MaxPredictionError = 2.0f;
+
+	//Remote players are drawn a little in the past, interpolated between received states, instead of extrapolated and snapped.
+	UPROPERTY(EditAnywhere, Category = Network)
+	bool bUseSnapshotInterpolation = true;
+
+	//The playout delay follows the measured send interval and jitter, within these limits.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, EditCondition = "bUseSnapshotInterpolation"))
+	float MinPlayoutDelay = 0.05f;
+
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, EditCondition = "bUseSnapshotInterpolation"))
+	float MaxPlayoutDelay = 0.3f;
+
+	//Margin on top of the send interval, in measured jitter. Higher hides more late packets at the cost of latency.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, EditCondition = "bUseSnapshotInterpolation"))
+	float PlayoutJitterMultiplier = 2.0f;
+
+	//How long a remote player keeps moving when no newer state has arrived.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, EditCondition = "bUseSnapshotInterpolation"))
+	float MaxSnapshotExtrapolationTime = 0.1f;
 };
@@ -0,0 +1,53 @@
+#include "FGSendRateController.h"
+#include "Engine/NetConnection.h"
+
+//Milliseconds per second the lowest round trip time creeps up, so a route change is not taken for queueing forever.
+const static float BaseRttDrift = 5.0f;
+
+float FFGSendRateController::Update(UNetConnection* Connection, float DeltaTime, const FFGSendRateSettings& Settings)
+{
+	if (Connection == nullptr)
+	{
+		Scale = 1.0f;
+		return Scale;
+	}
+
+	bWasSaturated |= !Connection->IsNetReady(false);
+	TimeSinceSample += DeltaTime;
+
+	if (TimeSinceSample < Settings.SampleInterval)
+	{
+		return Scale;
+	}
+
+	const int32 NumOutPackets = Connection->OutTotalPackets - LastOutPackets;
+	const int32 NumOutPacketsLost = Connection->OutTotalPacketsLost - LastOutPacketsLost;
+	LastOutPackets = Connection->OutTotalPackets;
+	LastOutPacketsLost = Connection->OutTotalPacketsLost;
+
+	const float Loss = NumOutPackets > 0 ? 100.0f * NumOutPacketsLost / NumOutPackets : 0.0f;
+	const float Rtt = Connection->AvgLag * 1000.0f;
+	bool bIsQueueing = false;
+
+	if (Rtt > 0.0f)
+	{
+		BaseRtt = FMath::Min(BaseRtt + BaseRttDrift * TimeSinceSample, Rtt);
+		bIsQueueing = Rtt - BaseRtt > Settings.MaxQueueDelay;
+	}
+
+	//The first sample has no interval to judge loss over.
+	if (bHasSample && (bWasSaturated || bIsQueueing || Loss > Settings.MaxLoss))
+	{
+		Scale *= Settings.DecreaseFactor;
+	}
+
+	else
+	{
+		Scale = FMath::Min(Scale + Settings.RecoveryRate * TimeSinceSample, 1.0f);
+	}
+
+	bHasSample = true;
+	bWasSaturated = false;
+	TimeSinceSample = 0.0f;
+	return Scale;
+}
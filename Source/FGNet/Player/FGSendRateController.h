@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FGSendRateController.generated.h"
+
+class UNetConnection;
+
+USTRUCT()
+struct FFGSendRateSettings
+{
+	GENERATED_BODY()
+
+	//Round trip time above the lowest one seen before the link counts as queueing, in milliseconds.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float MaxQueueDelay = 50.0f;
+
+	//Percent of outgoing packets lost over a sample before the link counts as congested.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, ClampMax = 100.0))
+	float MaxLoss = 2.0f;
+
+	//The rate scale is multiplied by this after a congested sample.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0, ClampMax = 1.0))
+	float DecreaseFactor = 0.5f;
+
+	//How much of the rate range is won back per second while the link is fine.
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.0))
+	float RecoveryRate = 0.25f;
+
+	UPROPERTY(EditAnywhere, Category = Network, meta = (ClampMin = 0.05))
+	float SampleInterval = 0.5f;
+};
+
+//Additive increase, multiplicative decrease of a send rate for one connection. Backs off when the connection is
+//saturated, loses packets or its round trip time grows past the lowest one seen, and recovers slowly once it is fine,
+//so a degrading link sheds unreliable movement instead of queuing it in front of the reliable RPCs.
+class FGNET_API FFGSendRateController
+{
+public:
+
+	//Returns the scale, 1 for the full rate and 0 for the lowest. A null connection always gets the full rate.
+	float Update(UNetConnection* Connection, float DeltaTime, const FFGSendRateSettings& Settings);
+
+	float GetScale() const { return Scale; }
+
+	float GetRate(float MinRate, float MaxRate) const { return FMath::Lerp(MinRate, MaxRate, Scale); }
+
+private:
+
+	float Scale = 1.0f;
+
+	float TimeSinceSample = 0.0f;
+
+	//Saturation is only visible at the moment it happens, so it is remembered until the next sample.
+	bool bWasSaturated = false;
+
+	bool bHasSample = false;
+
+	int32 LastOutPackets = 0;
+
+	int32 LastOutPacketsLost = 0;
+
+	float BaseRtt = BIG_NUMBER;
+};
@@ -0,0 +1,124 @@
+#include "FGSnapshotBuffer.h"
+
+namespace
+{
+	//Smoothing factors for the running estimates, 1/16 is what RFC 3550 uses for jitter.
+	constexpr float JitterGain = 1.0f / 16.0f;
+	constexpr float ClockOffsetGain = 1.0f / 32.0f;
+	constexpr float SendIntervalGain = 1.0f / 8.0f;
+
+	//How fast the playout delay follows its target, fast changes would speed up or slow down remote players visibly.
+	constexpr float PlayoutDelayInterpSpeed = 1.0f;
+}
+
+FFGSnapshotBuffer::FFGSnapshotBuffer()
+{
+	Snapshots.SetNum(Capacity);
+}
+
+void FFGSnapshotBuffer::AddSnapshot(const FFGSnapshot& Snapshot, float LocalTime)
+{
+	const float TransitTime = LocalTime - Snapshot.TimeStamp;
+
+	if (Count == 0)
+	{
+		ClockOffset = TransitTime;
+		LastTransitTime = TransitTime;
+	}
+
+	else
+	{
+		const FFGSnapshot& Newest = GetSnapshot(Count - 1);
+
+		//Unreliable, anything older than what we have is useless for interpolation.
+		if (Snapshot.TimeStamp <= Newest.TimeStamp)
+		{
+			NumLateSnapshots++;
+			return;
+		}
+
+		Jitter += (FMath::Abs(TransitTime - LastTransitTime) - Jitter) * JitterGain;
+		ClockOffset += (TransitTime - ClockOffset) * ClockOffsetGain;
+		SendInterval += ((Snapshot.TimeStamp - Newest.TimeStamp) - SendInterval) * SendIntervalGain;
+		LastTransitTime = TransitTime;
+	}
+
+	if (Count == Capacity)
+	{
+		Head = (Head + 1) % Capacity;
+		Count--;
+	}
+
+	Snapshots[(Head + Count) % Capacity] = Snapshot;
+	Count++;
+}
+
+bool FFGSnapshotBuffer::Sample(float LocalTime, float DeltaTime, const FFGSnapshotBufferSettings& Settings, FVector& OutLocation, float& OutYaw)
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	//We need at least one send interval of delay to have a snapshot ahead of us, plus margin for the jitter.
+	const float TargetDelay = FMath::Clamp(SendInterval + Jitter * Settings.JitterMultiplier, Settings.MinPlayoutDelay, Settings.MaxPlayoutDelay);
+	PlayoutDelay = PlayoutDelay <= 0.0f ? TargetDelay : FMath::FInterpTo(PlayoutDelay, TargetDelay, DeltaTime, PlayoutDelayInterpSpeed);
+
+	PlayoutTime = LocalTime - ClockOffset - PlayoutDelay;
+
+	//Snapshots we have played past are no longer needed, keep the one right before the playout time.
+	while (Count > 2 && GetSnapshot(1).TimeStamp <= PlayoutTime)
+	{
+		Head = (Head + 1) % Capacity;
+		Count--;
+	}
+
+	const FFGSnapshot& From = GetSnapshot(0);
+
+	if (Count == 1 || PlayoutTime <= From.TimeStamp)
+	{
+		OutLocation = From.Location;
+		OutYaw = From.Yaw;
+		return true;
+	}
+
+	const FFGSnapshot& To = GetSnapshot(1);
+	const float Interval = FMath::Max(To.TimeStamp - From.TimeStamp, KINDA_SMALL_NUMBER);
+
+	//Past the newest snapshot we keep going a little, then hold.
+	const float MaxAlpha = 1.0f + Settings.MaxExtrapolationTime / Interval;
+	const float Alpha = FMath::Min((PlayoutTime - From.TimeStamp) / Interval, MaxAlpha);
+
+	OutLocation = FMath::Lerp(From.Location, To.Location, Alpha);
+	OutYaw = From.Yaw + FRotator::NormalizeAxis(To.Yaw - From.Yaw) * Alpha;
+	return true;
+}
+
+bool FFGSnapshotBuffer::GetLocationAt(float SenderTime, FVector& OutLocation) const
+{
+	for (int32 Index = 0; Index + 1 < Count; Index++)
+	{
+		const FFGSnapshot& From = GetSnapshot(Index);
+		const FFGSnapshot& To = GetSnapshot(Index + 1);
+
+		if (From.TimeStamp <= SenderTime && SenderTime <= To.TimeStamp)
+		{
+			const float Interval = FMath::Max(To.TimeStamp - From.TimeStamp, KINDA_SMALL_NUMBER);
+			OutLocation = FMath::Lerp(From.Location, To.Location, (SenderTime - From.TimeStamp) / Interval);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FFGSnapshotBuffer::Reset()
+{
+	Head = 0;
+	Count = 0;
+	Jitter = 0.0f;
+	SendInterval = 0.0f;
+	PlayoutDelay = 0.0f;
+	PlayoutTime = 0.0f;
+	NumLateSnapshots = 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGSnapshot
+{
+	//Sender clock, the owning client's move time.
+	float TimeStamp = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+
+	float Yaw = 0.0f;
+};
+
+struct FFGSnapshotBufferSettings
+{
+	float MinPlayoutDelay = 0.05f;
+
+	float MaxPlayoutDelay = 0.3f;
+
+	//How many jitter deviations of safety margin we keep on top of the send interval.
+	float JitterMultiplier = 2.0f;
+
+	//How long we keep going past the newest snapshot before holding still.
+	float MaxExtrapolationTime = 0.1f;
+};
+
+//Jitter buffer for a remote player: snapshots are played back a small, adaptive delay behind the sender,
+//interpolated between the two that bracket the playout time, so late or lost packets don't show as pops.
+class FGNET_API FFGSnapshotBuffer
+{
+public:
+
+	FFGSnapshotBuffer();
+
+	void AddSnapshot(const FFGSnapshot& Snapshot, float LocalTime);
+
+	//Returns false until we have anything to play back.
+	bool Sample(float LocalTime, float DeltaTime, const FFGSnapshotBufferSettings& Settings, FVector& OutLocation, float& OutYaw);
+
+	void Reset();
+
+	//Where the sender was at SenderTime, interpolated between the snapshots around it. Returns false outside of them.
+	bool GetLocationAt(float SenderTime, FVector& OutLocation) const;
+
+	//Sender time the last Sample played back.
+	float GetPlayoutTime() const { return PlayoutTime; }
+
+	float GetPlayoutDelay() const { return PlayoutDelay; }
+	float GetJitter() const { return Jitter; }
+	int32 GetNumLateSnapshots() const { return NumLateSnapshots; }
+
+private:
+
+	const FFGSnapshot& GetSnapshot(int32 Index) const { return Snapshots[(Head + Index) % Capacity]; }
+
+	static constexpr int32 Capacity = 32;
+
+	TArray<FFGSnapshot> Snapshots;
+
+	int32 Head = 0;
+
+	int32 Count = 0;
+
+	//Smoothed difference between our clock and the sender's, includes the average transit time.
+	float ClockOffset = 0.0f;
+
+	//Smoothed variation in transit time between consecutive snapshots (RFC 3550).
+	float Jitter = 0.0f;
+
+	float LastTransitTime = 0.0f;
+
+	//Smoothed time between snapshots as sent.
+	float SendInterval = 0.0f;
+
+	float PlayoutDelay = 0.0f;
+
+	float PlayoutTime = 0.0f;
+
+	int32 NumLateSnapshots = 0;
+};
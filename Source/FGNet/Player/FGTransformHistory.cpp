@@ -0,0 +1,64 @@
+#include "FGTransformHistory.h"
+
+FFGTransformHistory::FFGTransformHistory()
+{
+	Samples.SetNum(Capacity);
+}
+
+void FFGTransformHistory::Add(float Time, const FVector& Location)
+{
+	//Several adds in one frame only keep the last one.
+	if (Count > 0 && GetSample(Count - 1).Time >= Time)
+	{
+		Samples[(Head + Count - 1) % Capacity].Location = Location;
+		return;
+	}
+
+	if (Count == Capacity)
+	{
+		Head = (Head + 1) % Capacity;
+		Count--;
+	}
+
+	FFGTransformSample& Sample = Samples[(Head + Count) % Capacity];
+	Sample.Time = Time;
+	Sample.Location = Location;
+	Count++;
+}
+
+bool FFGTransformHistory::Sample(float Time, FVector& OutLocation) const
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	if (Time <= GetSample(0).Time)
+	{
+		OutLocation = GetSample(0).Location;
+		return true;
+	}
+
+	//Newest first, rewinds are short so the match is near the end.
+	for (int32 Index = Count - 1; Index > 0; Index--)
+	{
+		const FFGTransformSample& From = GetSample(Index - 1);
+		const FFGTransformSample& To = GetSample(Index);
+
+		if (Time >= From.Time)
+		{
+			const float Alpha = FMath::Clamp((Time - From.Time) / FMath::Max(To.Time - From.Time, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+			OutLocation = FMath::Lerp(From.Location, To.Location, Alpha);
+			return true;
+		}
+	}
+
+	OutLocation = GetSample(Count - 1).Location;
+	return true;
+}
+
+void FFGTransformHistory::Reset()
+{
+	Head = 0;
+	Count = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGTransformSample
+{
+	float Time = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+};
+
+//Server side ring of where a player's collision was recently, so hits can be tested against the past.
+class FGNET_API FFGTransformHistory
+{
+public:
+
+	FFGTransformHistory();
+
+	void Add(float Time, const FVector& Location);
+
+	//Interpolated location at Time, clamped to the oldest and newest samples. Returns false when empty.
+	bool Sample(float Time, FVector& OutLocation) const;
+
+	void Reset();
+
+private:
+
+	const FFGTransformSample& GetSample(int32 Index) const { return Samples[(Head + Index) % Capacity]; }
+
+	//About a second at 60 ticks per second, longer than any rewind we allow.
+	static constexpr int32 Capacity = 64;
+
+	TArray<FFGTransformSample> Samples;
+
+	int32 Head = 0;
+
+	int32 Count = 0;
+};